@@ -158,6 +158,8 @@ void ApplicationsPage::clear_applications()
 	get_window()->unset_items();
 	get_view()->unset_model();
 
+	m_search_index.clear();
+
 	for (std::map<std::string, Launcher*>::iterator i = m_items.begin(), end = m_items.end(); i != end; ++i)
 	{
 		delete i->second;
@@ -232,6 +234,9 @@ void ApplicationsPage::load_garcon_menu()
 	}
 	category->sort();
 	m_all_items_category = category;
+
+	// Create search index
+	m_search_index.build(category->get_items());
 }
 
 //-----------------------------------------------------------------------------
@@ -331,7 +336,14 @@ void ApplicationsPage::load_menu_item(GarconMenuItem* menu_item, Category* categ
 	std::map<std::string, Launcher*>::iterator iter = m_items.find(desktop_id);
 	if (iter == m_items.end())
 	{
-		iter = m_items.insert(std::make_pair(desktop_id, new Launcher(menu_item))).first;
+		Launcher* launcher = new Launcher(menu_item);
+		iter = m_items.insert(std::make_pair(desktop_id, launcher)).first;
+
+		// Let names in Chinese or Japanese be searched for in Latin letters
+		if (m_romanizer.romanize(launcher->get_display_name(), m_romanized_name))
+		{
+			launcher->set_romanized_name(m_romanized_name);
+		}
 	}
 
 	// Add menu item to current category
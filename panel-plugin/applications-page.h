@@ -20,6 +20,8 @@
 #define ZORIN_MENU_LITE_APPLICATIONS_PAGE_H
 
 #include "page.h"
+#include "romanizer.h"
+#include "search-index.h"
 
 #include <map>
 #include <string>
@@ -41,6 +43,11 @@ public:
 
 	Launcher* get_application(const std::string& desktop_id) const;
 
+	const SearchIndex* get_search_index() const
+	{
+		return &m_search_index;
+	}
+
 	void invalidate_applications();
 	bool load_applications();
 	void apply_filter(Category* category);
@@ -69,6 +76,9 @@ private:
 	std::vector<Category*> m_categories;
 	Category* m_all_items_category;
 	std::map<std::string, Launcher*> m_items;
+	Romanizer m_romanizer;
+	std::string m_romanized_name;
+	SearchIndex m_search_index;
 	int m_load_status;
 };
 
@@ -44,6 +44,11 @@ public:
 		return Type;
 	}
 
+	const std::vector<Element*>& get_items() const
+	{
+		return m_items;
+	}
+
 	GtkTreeModel* get_model();
 
 	bool empty() const;
@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "launch-history.h"
+
+#include "launcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <glib/gstdio.h>
+
+using namespace ZorinMenuLite;
+
+// Launches count half as much after a week
+static const gdouble half_life = 7 * 24 * 60 * 60;
+
+static const gchar magic[8] = { 'Z', 'M', 'L', 'H', 'I', 'S', 'T', '\0' };
+static const guint32 version = 2;
+
+//-----------------------------------------------------------------------------
+
+LaunchHistory::LaunchHistory() :
+	m_fd(-1),
+	m_header(NULL),
+	m_records(NULL),
+	m_ids_generation(0)
+{
+	g_mutex_init(&m_mutex);
+	m_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	open_file();
+}
+
+//-----------------------------------------------------------------------------
+
+LaunchHistory::~LaunchHistory()
+{
+	if (m_header)
+	{
+		munmap(m_header, sizeof(Header) + (max_records * sizeof(Record)));
+	}
+	if (m_fd != -1)
+	{
+		close(m_fd);
+	}
+	g_hash_table_destroy(m_ids);
+	g_mutex_clear(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+void LaunchHistory::record_launch(const Launcher* launcher)
+{
+	const gchar* desktop_id = launcher->get_desktop_id();
+	if (!m_header || !desktop_id || (strlen(desktop_id) >= sizeof(m_records->desktop_id)))
+	{
+		return;
+	}
+
+	// Other menus may record launches in the same file at the same time
+	g_mutex_lock(&m_mutex);
+	flock(m_fd, LOCK_EX);
+	update_ids();
+
+	gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+	gdouble score = 1.0;
+	guint index = find_record(desktop_id);
+	if (index)
+	{
+		--index;
+		score += get_score(index, now);
+	}
+	else
+	{
+		if (m_header->count < max_records)
+		{
+			index = m_header->count;
+			++m_header->count;
+		}
+		else
+		{
+			// Replace the launcher that counts the least
+			index = 0;
+			gdouble lowest = get_score(0, now);
+			for (guint i = 1; i < max_records; ++i)
+			{
+				gdouble i_score = get_score(i, now);
+				if (i_score < lowest)
+				{
+					index = i;
+					lowest = i_score;
+				}
+			}
+			g_hash_table_remove(m_ids, m_records[index].desktop_id);
+		}
+
+		memset(&m_records[index], 0, sizeof(Record));
+		g_strlcpy(m_records[index].desktop_id, desktop_id, sizeof(m_records->desktop_id));
+		g_hash_table_insert(m_ids, g_strdup(desktop_id), GUINT_TO_POINTER(index + 1));
+	}
+	m_records[index].score = score;
+	m_records[index].time = now;
+
+	// Tell other menus to look up records again
+	g_atomic_int_inc(&m_header->generation);
+	m_ids_generation = m_header->generation;
+
+	flock(m_fd, LOCK_UN);
+	g_mutex_unlock(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+void LaunchHistory::get_scores(const std::vector<Launcher*>& launchers, std::vector<guint>& scores) const
+{
+	scores.assign(launchers.size(), 0);
+	if (!m_header)
+	{
+		return;
+	}
+
+	g_mutex_lock(&m_mutex);
+	flock(m_fd, LOCK_SH);
+	update_ids();
+
+	gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+	for (std::vector<Launcher*>::size_type i = 0, end = launchers.size(); i < end; ++i)
+	{
+		const gchar* desktop_id = launchers[i]->get_desktop_id();
+		guint index = desktop_id ? find_record(desktop_id) : 0;
+		if (index)
+		{
+			scores[i] = guint(std::min(get_score(index - 1, now), 1000000.0) * 1000.0);
+		}
+	}
+
+	flock(m_fd, LOCK_UN);
+	g_mutex_unlock(&m_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+void LaunchHistory::open_file()
+{
+	gchar* dir = g_build_filename(g_get_user_cache_dir(), "xfce4", "zorinmenulite", NULL);
+	gchar* path = g_build_filename(dir, "launch-history", NULL);
+	if (g_mkdir_with_parents(dir, 0700) == 0)
+	{
+		m_fd = g_open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	}
+	g_free(path);
+	g_free(dir);
+	if (m_fd == -1)
+	{
+		return;
+	}
+
+	// Keep other menus from using the file until it is checked
+	flock(m_fd, LOCK_EX);
+
+	// Start over if file is not the expected size
+	const gsize size = sizeof(Header) + (max_records * sizeof(Record));
+	struct stat info;
+	bool reset = false;
+	if ((fstat(m_fd, &info) != 0) || (gsize(info.st_size) != size))
+	{
+		if ((ftruncate(m_fd, 0) != 0) || (ftruncate(m_fd, size) != 0))
+		{
+			flock(m_fd, LOCK_UN);
+			close(m_fd);
+			m_fd = -1;
+			return;
+		}
+		reset = true;
+	}
+
+	void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (data == MAP_FAILED)
+	{
+		flock(m_fd, LOCK_UN);
+		close(m_fd);
+		m_fd = -1;
+		return;
+	}
+	m_header = reinterpret_cast<Header*>(data);
+	m_records = reinterpret_cast<Record*>(m_header + 1);
+
+	if (reset
+			|| (memcmp(m_header->magic, magic, sizeof(magic)) != 0)
+			|| (m_header->version != version)
+			|| (m_header->count > max_records))
+	{
+		reset_file();
+	}
+
+	// Look up records by desktop id
+	m_ids_generation = m_header->generation - 1;
+	update_ids();
+
+	flock(m_fd, LOCK_UN);
+}
+
+//-----------------------------------------------------------------------------
+
+void LaunchHistory::reset_file()
+{
+	gint32 generation = m_header->generation;
+	memset(m_header, 0, sizeof(Header) + (max_records * sizeof(Record)));
+	memcpy(m_header->magic, magic, sizeof(magic));
+	m_header->version = version;
+	m_header->generation = generation + 1;
+}
+
+//-----------------------------------------------------------------------------
+
+void LaunchHistory::update_ids() const
+{
+	// Look up records by desktop id again if other menus changed them;
+	// ids are copied, as other menus may overwrite the records
+	if (m_ids_generation == m_header->generation)
+	{
+		return;
+	}
+	m_ids_generation = m_header->generation;
+
+	g_hash_table_remove_all(m_ids);
+	for (guint i = 0, end = std::min(m_header->count, guint32(max_records)); i < end; ++i)
+	{
+		gchar* desktop_id = g_strndup(m_records[i].desktop_id, sizeof(m_records->desktop_id) - 1);
+		g_hash_table_insert(m_ids, desktop_id, GUINT_TO_POINTER(i + 1));
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+guint LaunchHistory::find_record(const gchar* desktop_id) const
+{
+	// Check that the record still has the id, in case the file was changed
+	// without taking the lock
+	guint index = GPOINTER_TO_UINT(g_hash_table_lookup(m_ids, desktop_id));
+	if (index && ((index > m_header->count)
+			|| (strncmp(m_records[index - 1].desktop_id, desktop_id, sizeof(m_records->desktop_id)) != 0)))
+	{
+		return 0;
+	}
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+
+gdouble LaunchHistory::get_score(guint index, gint64 now) const
+{
+	const Record& record = m_records[index];
+	gdouble age = std::max(now - record.time, gint64(0));
+	return record.score * std::pow(2.0, -age / half_life);
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZORIN_MENU_LITE_LAUNCH_HISTORY_H
+#define ZORIN_MENU_LITE_LAUNCH_HISTORY_H
+
+#include <vector>
+
+#include <glib.h>
+
+namespace ZorinMenuLite
+{
+
+class Launcher;
+
+// Remembers how often and how recently launchers were run, in a file of
+// fixed size records that is mapped into memory instead of parsed
+class LaunchHistory
+{
+public:
+	LaunchHistory();
+	~LaunchHistory();
+
+	// Changes every time a launch is recorded, including by other menus
+	// sharing the file
+	guint get_serial() const
+	{
+		return m_header ? guint(g_atomic_int_get(&m_header->generation)) : 0;
+	}
+
+	void record_launch(const Launcher* launcher);
+
+	// Fills scores with the frecency of each launcher, which is higher for
+	// launchers that were run more often and more recently
+	void get_scores(const std::vector<Launcher*>& launchers, std::vector<guint>& scores) const;
+
+private:
+	void open_file();
+	void reset_file();
+	void update_ids() const;
+	guint find_record(const gchar* desktop_id) const;
+	gdouble get_score(guint index, gint64 now) const;
+
+	struct Header
+	{
+		gchar magic[8];
+		guint32 version;
+		guint32 count;
+		gint32 generation;
+		guint32 reserved;
+	};
+
+	struct Record
+	{
+		gchar desktop_id[112];
+		gdouble score;
+		gint64 time;
+	};
+
+	enum
+	{
+		max_records = 512
+	};
+
+private:
+	gint m_fd;
+	Header* m_header;
+	Record* m_records;
+	GHashTable* m_ids;
+	mutable gint32 m_ids_generation;
+	mutable GMutex m_mutex;
+};
+
+}
+
+#endif // ZORIN_MENU_LITE_LAUNCH_HISTORY_H
@@ -18,7 +18,7 @@
 
 #include "launcher.h"
 
-#include "query.h"
+#include "search-corpus.h"
 
 #include <exo/exo.h>
 #include <libxfce4ui/libxfce4ui.h>
@@ -27,33 +27,6 @@ using namespace ZorinMenuLite;
 
 //-----------------------------------------------------------------------------
 
-static std::string normalize(const gchar* string)
-{
-	std::string result;
-
-	gchar* normalized = g_utf8_normalize(string, -1, G_NORMALIZE_DEFAULT);
-	if (G_UNLIKELY(!normalized))
-	{
-		return result;
-	}
-
-	gchar* utf8 = g_utf8_casefold(normalized, -1);
-	if (G_UNLIKELY(!utf8))
-	{
-		g_free(normalized);
-		return result;
-	}
-
-	result = utf8;
-
-	g_free(utf8);
-	g_free(normalized);
-
-	return result;
-}
-
-//-----------------------------------------------------------------------------
-
 static void replace_with_quoted_string(std::string& command, size_t& index, const gchar* unquoted)
 {
 	if (!exo_str_is_empty(unquoted))
@@ -162,18 +135,6 @@ Launcher::Launcher(GarconMenuItem* item) :
 	set_text(g_markup_printf_escaped("%s%s", direction, m_display_name));
 	set_tooltip(details);
 
-	// Create search text for display name
-	m_search_name = normalize(m_display_name);
-	m_search_generic_name = normalize(generic_name);
-	m_search_comment = normalize(details);
-
-	// Create search text for command
-	const gchar* command = garcon_menu_item_get_command(m_item);
-	if (!exo_str_is_empty(command) && g_utf8_validate(command, -1, NULL))
-	{
-		m_search_command = normalize(command);
-	}
-
 	// Fetch desktop actions
 #ifdef GARCON_TYPE_MENU_ITEM_ACTION
 	GList* actions = garcon_menu_item_get_actions(m_item);
@@ -201,6 +162,72 @@ Launcher::~Launcher()
 
 //-----------------------------------------------------------------------------
 
+void Launcher::get_search_texts(std::string* texts) const
+{
+	const gchar* generic_name = garcon_menu_item_get_generic_name(m_item);
+	if (G_UNLIKELY(!generic_name) || !g_utf8_validate(generic_name, -1, NULL))
+	{
+		generic_name = "";
+	}
+
+	const gchar* details = garcon_menu_item_get_comment(m_item);
+	if (!details || !g_utf8_validate(details, -1, NULL))
+	{
+		details = generic_name;
+	}
+
+	texts[SearchCorpus::Name] = m_display_name;
+	texts[SearchCorpus::GenericName] = generic_name;
+	texts[SearchCorpus::Romanized] = m_romanized_name;
+	texts[SearchCorpus::Comment] = details;
+
+	// Separate keywords with new lines, which begin words like spaces do,
+	// so that each keyword is matched at its start; matching the initials
+	// or the characters of the query in order still spans keywords
+	texts[SearchCorpus::Keywords].clear();
+#if GARCON_CHECK_VERSION(0,6,0)
+	for (GList* i = garcon_menu_item_get_keywords(m_item); i != NULL; i = i->next)
+	{
+		const gchar* keyword = reinterpret_cast<gchar*>(i->data);
+		if (!exo_str_is_empty(keyword) && g_utf8_validate(keyword, -1, NULL))
+		{
+			if (!texts[SearchCorpus::Keywords].empty())
+			{
+				texts[SearchCorpus::Keywords] += '\n';
+			}
+			texts[SearchCorpus::Keywords] += keyword;
+		}
+	}
+#endif
+
+	// Separate actions the same way as keywords
+	texts[SearchCorpus::Actions].clear();
+	for (std::vector<DesktopAction*>::size_type i = 0, end = m_actions.size(); i < end; ++i)
+	{
+		const gchar* action_name = m_actions[i]->get_name();
+		if (!exo_str_is_empty(action_name) && g_utf8_validate(action_name, -1, NULL))
+		{
+			if (!texts[SearchCorpus::Actions].empty())
+			{
+				texts[SearchCorpus::Actions] += '\n';
+			}
+			texts[SearchCorpus::Actions] += action_name;
+		}
+	}
+
+	const gchar* command = garcon_menu_item_get_command(m_item);
+	if (!exo_str_is_empty(command) && g_utf8_validate(command, -1, NULL))
+	{
+		texts[SearchCorpus::Command] = command;
+	}
+	else
+	{
+		texts[SearchCorpus::Command].clear();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
 void Launcher::run(GdkScreen* screen) const
 {
 	const gchar* string = garcon_menu_item_get_command(m_item);
@@ -353,37 +380,3 @@ void Launcher::run(GdkScreen* screen, DesktopAction* action) const
 }
 
 //-----------------------------------------------------------------------------
-
-guint Launcher::search(const Query& query)
-{
-	// Sort matches in names first
-	guint match = query.match(m_search_name);
-	if (match != G_MAXUINT)
-	{
-		return match | 0x400;
-	}
-
-	match = query.match(m_search_generic_name);
-	if (match != G_MAXUINT)
-	{
-		return match | 0x800;
-	}
-
-	// Sort matches in comments next
-	match = query.match(m_search_comment);
-	if (match != G_MAXUINT)
-	{
-		return match | 0x1000;
-	}
-
-	// Sort matches in executables last
-	match = query.match(m_search_command);
-	if (match != G_MAXUINT)
-	{
-		return match | 0x2000;
-	}
-
-	return G_MAXUINT;
-}
-
-//-----------------------------------------------------------------------------
@@ -118,19 +118,23 @@ public:
 		return garcon_menu_item_get_uri(m_item);
 	}
 
+	// Fills texts with the text of each field of SearchCorpus
+	void get_search_texts(std::string* texts) const;
+
+	// Name spelled in Latin letters, if it is written in another script
+	void set_romanized_name(const std::string& name)
+	{
+		m_romanized_name = name;
+	}
+
 	void run(GdkScreen* screen) const;
 
 	void run(GdkScreen* screen, DesktopAction* action) const;
 
-	guint search(const Query& query);
-
 private:
 	GarconMenuItem* m_item;
 	const gchar* m_display_name;
-	std::string m_search_name;
-	std::string m_search_generic_name;
-	std::string m_search_comment;
-	std::string m_search_command;
+	std::string m_romanized_name;
 	std::vector<DesktopAction*> m_actions;
 };
 
@@ -18,6 +18,7 @@
 
 #include "page.h"
 
+#include "launch-history.h"
 #include "launcher.h"
 #include "launcher-view.h"
 #include "slot.h"
@@ -141,6 +142,12 @@ void Page::item_activated(GtkTreeView* view, GtkTreePath* path, GtkTreeViewColum
 		return;
 	}
 
+	// Remember launch for ranking search results
+	if (element->get_type() == Launcher::Type)
+	{
+		m_window->get_launch_history()->record_launch(static_cast<Launcher*>(element));
+	}
+
 	// Hide window
 	m_window->hide();
 
@@ -158,6 +165,9 @@ void Page::item_action_activated(GtkMenuItem* menuitem, DesktopAction* action)
 		return;
 	}
 
+	// Remember launch for ranking search results
+	m_window->get_launch_history()->record_launch(launcher);
+
 	// Hide window
 	m_window->hide();
 
@@ -18,31 +18,151 @@
 
 #include "query.h"
 
-#include <sstream>
+#include "search-text.h"
+
+#include <algorithm>
 
 #include <climits>
 #include <cstring>
 
+#include <stdint.h>
+
 #include <glib.h>
 
 using namespace ZorinMenuLite;
 
 //-----------------------------------------------------------------------------
 
-static inline bool is_start_word(const std::string& string, std::string::size_type pos)
+static const uint64_t high_bits = 0x8080808080808080ULL;
+
+static inline uint64_t repeat_byte(unsigned char byte)
+{
+	return 0x0101010101010101ULL * byte;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool is_ascii(const char* string, size_t length)
+{
+	// Check eight bytes at a time for any byte with its high bit set
+	size_t i = 0;
+	for (; (i + sizeof(uint64_t)) <= length; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, string + i, sizeof(uint64_t));
+		if (word & high_bits)
+		{
+			return false;
+		}
+	}
+
+	for (; i < length; ++i)
+	{
+		if (static_cast<unsigned char>(string[i]) & 0x80)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void ascii_lowercase(char* string, size_t length)
+{
+	// Set bit 0x20 of every byte in 'A'..'Z', eight bytes at a time; bytes
+	// are all below 0x80 so the additions can not carry into the next byte
+	size_t i = 0;
+	for (; (i + sizeof(uint64_t)) <= length; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, string + i, sizeof(uint64_t));
+		uint64_t above_z = word + repeat_byte(0x7F - 'Z');
+		uint64_t from_a = word + repeat_byte(0x80 - 'A');
+		uint64_t upper = from_a & ~above_z & high_bits;
+		word |= upper >> 2;
+		memcpy(string + i, &word, sizeof(uint64_t));
+	}
+
+	for (; i < length; ++i)
+	{
+		if ((string[i] >= 'A') && (string[i] <= 'Z'))
+		{
+			string[i] |= 0x20;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+static std::string::size_type find_text(const char* text, std::string::size_type length, const char* needle, std::string::size_type needle_length)
+{
+	if (needle_length > length)
+	{
+		return std::string::npos;
+	}
+	else if (!needle_length)
+	{
+		return 0;
+	}
+
+	// Look for first byte of needle, and then compare the rest
+	const char* end = text + (length - needle_length) + 1;
+	for (const char* pos = text; pos < end; ++pos)
+	{
+		pos = static_cast<const char*>(memchr(pos, needle[0], end - pos));
+		if (!pos)
+		{
+			break;
+		}
+		else if (memcmp(pos + 1, needle + 1, needle_length - 1) == 0)
+		{
+			return pos - text;
+		}
+	}
+	return std::string::npos;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool has_word(const SearchText& haystack, unsigned int offset, const char* word, std::string::size_type length)
+{
+	return ((haystack.length() - offset) >= length)
+			&& (memcmp(haystack.text() + offset, word, length) == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+static bool is_space(char c)
 {
-	return (pos == 0) || g_unichar_isspace(g_utf8_get_char(g_utf8_prev_char(&string.at(pos))));
+	return (c == ' ') || ((c >= '\t') && (c <= '\r'));
 }
 
 //-----------------------------------------------------------------------------
 
-Query::Query()
+Query::Query() :
+	m_query_signature(0),
+	m_match(&Query::match_nothing),
+	m_max_errors(0),
+	m_approximate_last(0)
 {
+	m_raw_query.reserve(preallocated_length);
+	m_query.reserve(preallocated_length);
+	m_folded_query.reserve(preallocated_length);
+	m_query_words.reserve(preallocated_length / 2);
+	m_query_codepoints.reserve(preallocated_length);
+	m_approximate_unicode.reserve(64);
+	m_approximate_pieces.reserve(max_approximate_errors + 1);
 }
 
 //-----------------------------------------------------------------------------
 
-Query::Query(const std::string& query)
+Query::Query(const std::string& query) :
+	m_query_signature(0),
+	m_match(&Query::match_nothing),
+	m_max_errors(0),
+	m_approximate_last(0)
 {
 	set(query);
 }
@@ -56,50 +176,78 @@ Query::~Query()
 
 //-----------------------------------------------------------------------------
 
-unsigned int Query::match(const std::string& haystack) const
+unsigned int Query::match_nothing(const SearchText&) const
 {
-	// Make sure haystack is longer than query
-	if (m_query.empty() || (m_query.length() > haystack.length()))
+	return UINT_MAX;
+}
+
+//-----------------------------------------------------------------------------
+
+template<unsigned int Plan>
+unsigned int Query::match_plan(const SearchText& haystack) const
+{
+	// Make sure haystack is longer than query, even without accents
+	const char* text = haystack.text();
+	const std::string::size_type length = haystack.length();
+	if (folded_query().length() > haystack.folded_length())
+	{
+		return UINT_MAX;
+	}
+
+	// Skip haystacks that are missing any character of query; every tier
+	// needs them, at least without accents
+	if ((haystack.signature() & m_query_signature) != m_query_signature)
 	{
 		return UINT_MAX;
 	}
 
 	// Check if haystack begins with or is query
-	std::string::size_type pos = haystack.find(m_query);
+	std::string::size_type pos = (Plan & PlanLong) ? find_horspool(text, length) : find_text(text, length, m_query.data(), m_query.length());
 	if (pos == 0)
 	{
-		return (haystack.length() == m_query.length()) ? 0x4 : 0x8;
+		return (length == m_query.length()) ? MatchEqual : MatchPrefix;
 	}
 	// Check if haystack contains query starting at a word boundary
-	else if ((pos != std::string::npos) && is_start_word(haystack, pos))
+	else if ((pos != std::string::npos) && haystack.is_start_word(pos))
 	{
-		return 0x10;
+		return MatchWordPrefix;
 	}
 
-	if (m_query_words.size() > 1)
+	if (Plan & PlanWords)
 	{
+		const unsigned int* word_starts = haystack.word_starts();
+		const unsigned int count = haystack.word_count();
+
 		// Check if haystack contains query as words
-		std::string::size_type search_pos = 0;
-		for (std::vector<std::string>::const_iterator i = m_query_words.begin(), end = m_query_words.end(); i != end; ++i)
+		unsigned int word_start = 0;
+		for (std::vector<Piece>::const_iterator i = m_query_words.begin(), end = m_query_words.end(); i != end; ++i)
 		{
-			search_pos = haystack.find(*i, search_pos);
-			if ((search_pos == std::string::npos) || !is_start_word(haystack, search_pos))
+			while ((word_start < count) && !has_word(haystack, word_starts[word_start], m_query.data() + i->offset, i->length))
+			{
+				++word_start;
+			}
+			if (word_start == count)
 			{
-				search_pos = std::string::npos;
 				break;
 			}
 		}
-		if (search_pos != std::string::npos)
+		if (word_start < count)
 		{
-			return 0x20;
+			return MatchWords;
 		}
 
 		// Check if haystack contains query as words in any order
-		std::vector<std::string>::size_type found_words = 0;
-		for (std::vector<std::string>::const_iterator i = m_query_words.begin(), end = m_query_words.end(); i != end; ++i)
+		std::vector<Piece>::size_type found_words = 0;
+		for (std::vector<Piece>::const_iterator i = m_query_words.begin(), end = m_query_words.end(); i != end; ++i)
 		{
-			search_pos = haystack.find(*i);
-			if ((search_pos != std::string::npos) && is_start_word(haystack, search_pos))
+			for (word_start = 0; word_start < count; ++word_start)
+			{
+				if (has_word(haystack, word_starts[word_start], m_query.data() + i->offset, i->length))
+				{
+					break;
+				}
+			}
+			if (word_start < count)
 			{
 				++found_words;
 			}
@@ -110,50 +258,161 @@ unsigned int Query::match(const std::string& haystack) const
 		}
 		if (found_words == m_query_words.size())
 		{
-			return 0x40;
+			return MatchWordsUnordered;
 		}
 	}
 
 	// Check if haystack contains query
 	if (pos != std::string::npos)
 	{
-		return 0x80;
+		return MatchContains;
 	}
 
-	// Check if haystack contains query as characters
-	bool characters_start_words = true;
-	bool start_word = true;
-	bool started = false;
-	const gchar* query_string = m_query.c_str();
-	for (const gchar* pos = haystack.c_str(); *pos; pos = g_utf8_next_char(pos))
+	// Check if haystack contains query when ignoring accents
+	if ((haystack.has_folded_text() || (!(Plan & PlanAscii) && !m_folded_query.empty()))
+			&& (find_text(haystack.folded_text(), haystack.folded_length(), folded_query().data(), folded_query().length()) != std::string::npos))
 	{
-		gunichar c = g_utf8_get_char(pos);
-		if (c == g_utf8_get_char(query_string))
+		return MatchFolded;
+	}
+
+	// Check if query is made of the first characters of words
+	const unsigned int* initials = haystack.initials();
+	const unsigned int initial_count = haystack.initial_count();
+	const std::vector<unsigned int>::size_type query_length = m_query_codepoints.size();
+	std::vector<unsigned int>::size_type matched = 0;
+	if (!(Plan & PlanWords))
+	{
+		for (unsigned int i = 0; (i < initial_count) && (matched < query_length); ++i)
 		{
-			if (start_word || started)
+			if (initials[i] == m_query_codepoints[matched])
 			{
-				characters_start_words &= start_word;
-				query_string = g_utf8_next_char(query_string);
-				started = true;
+				++matched;
 			}
-			start_word = false;
 		}
-		else if (g_unichar_isspace(c))
+		if (matched == query_length)
 		{
-			start_word = true;
+			return MatchInitials;
 		}
-		else
+	}
+
+	// Check if haystack contains query as characters, starting at a word
+	unsigned int word = 0;
+	while ((word < initial_count) && (initials[word] != m_query_codepoints[0]))
+	{
+		++word;
+	}
+	if (word == initial_count)
+	{
+		return UINT_MAX;
+	}
+
+	const unsigned int* codepoints = haystack.codepoints();
+	matched = 1;
+	for (unsigned int i = haystack.initial_indices()[word] + 1, end = haystack.codepoint_count(); (i < end) && (matched < query_length); ++i)
+	{
+		if (codepoints[i] == m_query_codepoints[matched])
 		{
-			start_word = false;
+			++matched;
 		}
 	}
-	unsigned int result = UINT_MAX;
-	if (*query_string == 0)
+
+	return (matched == query_length) ? static_cast<unsigned int>(MatchCharacters) : UINT_MAX;
+}
+
+//-----------------------------------------------------------------------------
+
+std::string::size_type Query::find_horspool(const char* haystack, std::string::size_type haystack_length) const
+{
+	const std::string::size_type length = m_query.length();
+	if (length > haystack_length)
 	{
-		result = characters_start_words ? 0x100 : 0x200;
+		return std::string::npos;
 	}
 
-	return result;
+	// Compare the last byte of each window first, and shift by how far
+	// that byte is from the end of query
+	const char* needle = m_query.data();
+	const unsigned char last = needle[length - 1];
+	for (std::string::size_type pos = 0, end = haystack_length - length; pos <= end; )
+	{
+		unsigned char byte = haystack[pos + length - 1];
+		if ((byte == last) && (memcmp(haystack + pos, needle, length - 1) == 0))
+		{
+			return pos;
+		}
+		pos += m_skip[byte];
+	}
+	return std::string::npos;
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int Query::match_approximate(const SearchText& haystack) const
+{
+	if (!m_max_errors)
+	{
+		return UINT_MAX;
+	}
+
+	// Any text within max errors of query contains one of max errors + 1
+	// pieces of query unchanged, so skip haystacks that contain none
+	const char* text = haystack.text();
+	const char* text_end = text + haystack.length();
+	std::vector<Piece>::const_iterator piece, pieces_end = m_approximate_pieces.end();
+	for (piece = m_approximate_pieces.begin(); piece != pieces_end; ++piece)
+	{
+		if (find_text(text, haystack.length(), m_query.data() + piece->offset, piece->length) != std::string::npos)
+		{
+			break;
+		}
+	}
+	if (piece == pieces_end)
+	{
+		return UINT_MAX;
+	}
+
+	// Check if haystack contains query with up to two typos, using the
+	// bit-parallel algorithm of Wu and Manber: bit i of state[d] is set if
+	// the first i + 1 characters of query end here with at most d errors
+	uint64_t state[max_approximate_errors + 1];
+	for (unsigned int d = 0; d <= m_max_errors; ++d)
+	{
+		state[d] = (G_GUINT64_CONSTANT(1) << d) - 1;
+	}
+
+	unsigned int errors = max_approximate_errors + 1;
+	for (const gchar* pos = text; pos < text_end; pos = g_utf8_next_char(pos))
+	{
+		unsigned char byte = *pos;
+		uint64_t mask = (byte < 128) ? m_approximate_ascii[byte] : approximate_mask(g_utf8_get_char(pos));
+		uint64_t previous = state[0];
+		state[0] = ((state[0] << 1) | 1) & mask;
+		for (unsigned int d = 1; d <= m_max_errors; ++d)
+		{
+			uint64_t current = state[d];
+			state[d] = (((current << 1) | 1) & mask)  // match
+					| previous  // insertion
+					| (previous << 1) | (state[d - 1] << 1) | 1;  // substitution and deletion
+			previous = current;
+		}
+
+		for (unsigned int d = 0; d < std::min(errors, m_max_errors + 1); ++d)
+		{
+			if (state[d] & m_approximate_last)
+			{
+				errors = d;
+				break;
+			}
+		}
+
+		// Stop once no better match is possible
+		if (errors < 2)
+		{
+			return MatchOneError;
+		}
+	}
+
+	return (errors <= m_max_errors) ? static_cast<unsigned int>(MatchTwoErrors) : UINT_MAX;
 }
 
 //-----------------------------------------------------------------------------
@@ -162,7 +421,14 @@ void Query::clear()
 {
 	m_raw_query.clear();
 	m_query.clear();
+	m_folded_query.clear();
 	m_query_words.clear();
+	m_query_codepoints.clear();
+	m_query_signature = 0;
+	m_match = &Query::match_nothing;
+	m_max_errors = 0;
+	m_approximate_unicode.clear();
+	m_approximate_pieces.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -170,7 +436,11 @@ void Query::clear()
 void Query::set(const std::string& query)
 {
 	m_query.clear();
+	m_folded_query.clear();
 	m_query_words.clear();
+	m_query_codepoints.clear();
+	m_query_signature = 0;
+	m_match = &Query::match_nothing;
 
 	m_raw_query = query;
 	if (m_raw_query.empty())
@@ -178,18 +448,255 @@ void Query::set(const std::string& query)
 		return;
 	}
 
-	gchar* normalized = g_utf8_normalize(m_raw_query.c_str(), -1, G_NORMALIZE_DEFAULT);
+	normalize(m_raw_query.c_str(), m_query);
+	fold(m_query, m_folded_query);
+
+	// Split query into words separated by whitespace
+	for (std::string::size_type i = 0, length = m_query.length(); i < length; )
+	{
+		if (is_space(m_query[i]))
+		{
+			++i;
+			continue;
+		}
+		Piece word = { i, 0 };
+		while ((i < length) && !is_space(m_query[i]))
+		{
+			++i;
+		}
+		word.length = i - word.offset;
+		m_query_words.push_back(word);
+	}
+
+	for (const gchar* pos = m_query.c_str(); *pos; pos = g_utf8_next_char(pos))
+	{
+		m_query_codepoints.push_back(g_utf8_get_char(pos));
+	}
+	m_query_signature = signature(folded_query().c_str());
+
+	// Pick the matcher for the shape of query, so that matching does not
+	// check it for every haystack
+	unsigned int plan = 0;
+	if (is_ascii(m_query.c_str(), m_query.length()))
+	{
+		plan |= PlanAscii;
+	}
+	if (m_query_words.size() > 1)
+	{
+		plan |= PlanWords;
+	}
+	if (m_query.length() >= 4)
+	{
+		plan |= PlanLong;
+
+		// Build skip table for finding query in haystacks
+		std::string::size_type length = m_query.length();
+		std::fill(m_skip, m_skip + 256, length);
+		for (std::string::size_type i = 0; i < (length - 1); ++i)
+		{
+			m_skip[static_cast<unsigned char>(m_query[i])] = length - 1 - i;
+		}
+	}
+
+	static const MatchFunction plans[] =
+	{
+		&Query::match_plan<0>,
+		&Query::match_plan<PlanAscii>,
+		&Query::match_plan<PlanWords>,
+		&Query::match_plan<PlanAscii | PlanWords>,
+		&Query::match_plan<PlanLong>,
+		&Query::match_plan<PlanLong | PlanAscii>,
+		&Query::match_plan<PlanLong | PlanWords>,
+		&Query::match_plan<PlanLong | PlanAscii | PlanWords>
+	};
+	m_match = plans[plan];
+
+	// Allow one typo in queries of four or more characters, and two in
+	// queries of eight or more characters
+	m_max_errors = 0;
+	m_approximate_unicode.clear();
+	m_approximate_pieces.clear();
+	glong length = g_utf8_strlen(m_query.c_str(), -1);
+	if ((length < 4) || (length > 64))
+	{
+		return;
+	}
+	m_max_errors = (length < 8) ? 1 : max_approximate_errors;
+	m_approximate_last = G_GUINT64_CONSTANT(1) << (length - 1);
+
+	// Store which positions of query each character is at
+	std::fill(m_approximate_ascii, m_approximate_ascii + 128, 0);
+	uint64_t bit = 1;
+	for (const gchar* pos = m_query.c_str(); *pos; pos = g_utf8_next_char(pos), bit <<= 1)
+	{
+		gunichar c = g_utf8_get_char(pos);
+		if (c < 128)
+		{
+			m_approximate_ascii[c] |= bit;
+			continue;
+		}
+
+		std::vector<std::pair<unsigned int, uint64_t> >::iterator i;
+		for (i = m_approximate_unicode.begin(); i != m_approximate_unicode.end(); ++i)
+		{
+			if (i->first == c)
+			{
+				i->second |= bit;
+				break;
+			}
+		}
+		if (i == m_approximate_unicode.end())
+		{
+			m_approximate_unicode.push_back(std::make_pair(c, bit));
+		}
+	}
+
+	// Split query into pieces for filtering haystacks
+	const gchar* start = m_query.c_str();
+	for (unsigned int i = 1; i <= (m_max_errors + 1); ++i)
+	{
+		const gchar* end = g_utf8_offset_to_pointer(m_query.c_str(), (i * length) / (m_max_errors + 1));
+		Piece piece = { std::string::size_type(start - m_query.c_str()), std::string::size_type(end - start) };
+		m_approximate_pieces.push_back(piece);
+		start = end;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+uint64_t Query::approximate_mask(unsigned int c) const
+{
+	if (c < 128)
+	{
+		return m_approximate_ascii[c];
+	}
+
+	for (std::vector<std::pair<unsigned int, uint64_t> >::const_iterator i = m_approximate_unicode.begin(), end = m_approximate_unicode.end(); i != end; ++i)
+	{
+		if (i->first == c)
+		{
+			return i->second;
+		}
+	}
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+std::string Query::normalize(const char* string)
+{
+	std::string result;
+	normalize(string, result);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+
+void Query::normalize(const char* string, std::string& result)
+{
+	// ASCII is unchanged by normalization, and casefolds to lowercase; it is
+	// written into result without allocating if result has room for it
+	size_t length = strlen(string);
+	if (is_ascii(string, length))
+	{
+		result.assign(string, length);
+		if (length)
+		{
+			ascii_lowercase(&result[0], length);
+		}
+		return;
+	}
+
+	result.clear();
+	gchar* normalized = g_utf8_normalize(string, length, G_NORMALIZE_DEFAULT);
+	if (G_UNLIKELY(!normalized))
+	{
+		return;
+	}
+
 	gchar* utf8 = g_utf8_casefold(normalized, -1);
-	m_query = utf8;
+	if (G_UNLIKELY(!utf8))
+	{
+		g_free(normalized);
+		return;
+	}
+
+	result.assign(utf8);
+
 	g_free(utf8);
 	g_free(normalized);
+}
+
+//-----------------------------------------------------------------------------
+
+std::string Query::fold(const std::string& string)
+{
+	std::string result;
+	fold(string, result);
+	return result;
+}
+
+//-----------------------------------------------------------------------------
 
-	std::string buffer;
-	std::stringstream ss(m_query);
-	while (ss >> buffer)
+void Query::fold(const std::string& string, std::string& result)
+{
+	result.clear();
+	if (is_ascii(string.c_str(), string.length()))
 	{
-		m_query_words.push_back(buffer);
+		return;
+	}
+
+	// Remove accents and other combining marks from decomposed text
+	gchar* decomposed = g_utf8_normalize(string.c_str(), -1, G_NORMALIZE_NFD);
+	if (!decomposed)
+	{
+		return;
+	}
+
+	bool folded = false;
+	for (const gchar* pos = decomposed; *pos; )
+	{
+		const gchar* next = g_utf8_next_char(pos);
+		if (g_unichar_ismark(g_utf8_get_char(pos)))
+		{
+			folded = true;
+		}
+		else
+		{
+			result.append(pos, next - pos);
+		}
+		pos = next;
+	}
+	g_free(decomposed);
+
+	if (!folded)
+	{
+		result.clear();
 	}
 }
 
 //-----------------------------------------------------------------------------
+
+uint64_t Query::signature(const char* string)
+{
+	uint64_t result = 0;
+	for (const gchar* pos = string; *pos; pos = g_utf8_next_char(pos))
+	{
+		gunichar c = g_utf8_get_char(pos);
+		if ((c >= 'a') && (c <= 'z'))
+		{
+			result |= uint64_t(1) << (c - 'a');
+		}
+		else if ((c >= '0') && (c <= '9'))
+		{
+			result |= uint64_t(1) << (c - '0' + 26);
+		}
+		else if (!g_unichar_isspace(c))
+		{
+			result |= uint64_t(1) << ((c % 28) + 36);
+		}
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
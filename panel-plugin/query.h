@@ -20,11 +20,16 @@
 #define ZORIN_MENU_LITE_QUERY_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <stdint.h>
+
 namespace ZorinMenuLite
 {
 
+class SearchText;
+
 class Query
 {
 public:
@@ -37,7 +42,32 @@ public:
 		return m_query.empty();
 	}
 
-	unsigned int match(const std::string& haystack) const;
+	// Relevancy of each way that text can match query, from best to worst;
+	// SearchCorpus adds the relevancy of the field that matched, from 0x400
+	// for names to 0x10000 for commands, so matches sort by field and then
+	// by tier, and approximate matches sort after every exact match
+	enum Relevancy
+	{
+		MatchEqual = 0x4,             // text is query
+		MatchPrefix = 0x8,            // text begins with query
+		MatchWordPrefix = 0x10,       // a word of text begins with query
+		MatchWords = 0x20,            // text has the words of query in order
+		MatchWordsUnordered = 0x40,   // text has the words of query
+		MatchContains = 0x80,         // text contains query
+		MatchFolded = 0xC0,           // text contains query without accents
+		MatchInitials = 0x100,        // query is initials of words of text
+		MatchCharacters = 0x200,      // text has characters of query in order
+		MatchOneError = 0x20000,      // text has query with at most one typo
+		MatchTwoErrors = 0x40000      // text has query with two typos
+	};
+
+	// Returns relevancy of haystack, or UINT_MAX if it does not match
+	unsigned int match(const SearchText& haystack) const
+	{
+		return (this->*m_match)(haystack);
+	}
+
+	unsigned int match_approximate(const SearchText& haystack) const;
 
 	const std::string& query() const
 	{
@@ -49,13 +79,81 @@ public:
 		return m_raw_query;
 	}
 
+	const std::string& folded_query() const
+	{
+		return m_folded_query.empty() ? m_query : m_folded_query;
+	}
+
+	uint64_t query_signature() const
+	{
+		return m_query_signature;
+	}
+
 	void clear();
 	void set(const std::string& query);
 
+	static std::string normalize(const char* string);
+	static void normalize(const char* string, std::string& result);
+
+	// Returns normalized string without accents, or an empty string if
+	// string has no accents
+	static std::string fold(const std::string& string);
+	static void fold(const std::string& string, std::string& result);
+
+	// Returns a bit for each of a-z and 0-9 in string, and a bit shared by
+	// several other characters for the rest, ignoring whitespace; text can
+	// only match a query if it has every bit of the signature of the query
+	static uint64_t signature(const char* string);
+
+private:
+	unsigned int match_nothing(const SearchText& haystack) const;
+	template<unsigned int Plan>
+	unsigned int match_plan(const SearchText& haystack) const;
+	std::string::size_type find_horspool(const char* haystack, std::string::size_type haystack_length) const;
+	uint64_t approximate_mask(unsigned int c) const;
+
+	typedef unsigned int (Query::*MatchFunction)(const SearchText& haystack) const;
+
+	// Part of query, kept as a range so that setting query does not copy it
+	struct Piece
+	{
+		std::string::size_type offset;
+		std::string::size_type length;
+	};
+
+	enum
+	{
+		// Queries up to this many bytes are set without allocating
+		preallocated_length = 256
+	};
+
+	enum
+	{
+		PlanAscii = 0x1,
+		PlanWords = 0x2,
+		PlanLong = 0x4
+	};
+
+	enum
+	{
+		max_approximate_errors = 2
+	};
+
 private:
 	std::string m_raw_query;
 	std::string m_query;
-	std::vector<std::string> m_query_words;
+	std::string m_folded_query;
+	std::vector<Piece> m_query_words;
+	std::vector<unsigned int> m_query_codepoints;
+	uint64_t m_query_signature;
+	MatchFunction m_match;
+	std::string::size_type m_skip[256];
+
+	unsigned int m_max_errors;
+	uint64_t m_approximate_last;
+	uint64_t m_approximate_ascii[128];
+	std::vector<std::pair<unsigned int, uint64_t> > m_approximate_unicode;
+	std::vector<Piece> m_approximate_pieces;
 };
 
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZORIN_MENU_LITE_ROMANIZER_H
+#define ZORIN_MENU_LITE_ROMANIZER_H
+
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace ZorinMenuLite
+{
+
+// Spells Chinese characters in pinyin and Japanese kana in romaji, so that
+// launchers named in those scripts can be found by typing Latin letters
+class Romanizer
+{
+public:
+	Romanizer();
+
+	// Sets result to text with Chinese characters and kana spelled in Latin
+	// letters, and returns false if text has neither; each pinyin syllable
+	// and each run of kana begins with an uppercase letter, so that they
+	// begin words in SearchCorpus; names with characters that have another
+	// common reading are spelled both ways
+	bool romanize(const gchar* text, std::string& result);
+
+private:
+	bool spell(const gchar* text, bool other_readings, std::string& result);
+	void load_pinyin();
+	const gchar* find_pinyin(gunichar c) const;
+	const gchar* find_other_pinyin(gunichar c) const;
+	void append_kana(gunichar c, std::string& result);
+
+	struct Reading
+	{
+		gunichar character;
+		guint16 syllable;
+
+		bool operator<(const Reading& reading) const
+		{
+			return character < reading.character;
+		}
+	};
+
+	enum Previous
+	{
+		PreviousSpace,
+		PreviousOther,
+		PreviousPinyin,
+		PreviousKana
+	};
+
+private:
+	bool m_pinyin_enabled;
+	std::vector<Reading> m_readings;
+	Previous m_previous;
+	std::string::size_type m_kana_start;
+	std::string::size_type m_syllable_start;
+	bool m_double_consonant;
+	bool m_has_other_reading;
+};
+
+}
+
+#endif // ZORIN_MENU_LITE_ROMANIZER_H
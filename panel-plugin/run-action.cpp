@@ -20,13 +20,16 @@
 
 #include "query.h"
 
+#include <cstring>
+
 #include <libxfce4ui/libxfce4ui.h>
 
 using namespace ZorinMenuLite;
 
 //-----------------------------------------------------------------------------
 
-RunAction::RunAction()
+RunAction::RunAction() :
+	m_program_found(false)
 {
 	set_icon("system-run");
 }
@@ -47,16 +50,31 @@ void RunAction::run(GdkScreen* screen) const
 
 guint RunAction::search(const Query& query)
 {
-	// Check if in PATH
+	// Check if in PATH, only parsing command lines that quote or escape
+	// text like a shell; others start with the program up to a space
+	const std::string& command_line = query.raw_query();
 	bool valid = false;
-
-	gchar** argv;
-	if (g_shell_parse_argv(query.raw_query().c_str(), NULL, &argv, NULL))
+	if (command_line.find_first_of("\"'\\#") != std::string::npos)
+	{
+		gchar** argv;
+		if (g_shell_parse_argv(command_line.c_str(), NULL, &argv, NULL))
+		{
+			valid = find_program(argv[0], strlen(argv[0]));
+			g_strfreev(argv);
+		}
+	}
+	else
 	{
-		gchar* path = g_find_program_in_path(argv[0]);
-		valid = path != NULL;
-		g_free(path);
-		g_strfreev(argv);
+		std::string::size_type start = command_line.find_first_not_of(" \t\n");
+		if (start != std::string::npos)
+		{
+			std::string::size_type end = command_line.find_first_of(" \t\n", start);
+			if (end == std::string::npos)
+			{
+				end = command_line.length();
+			}
+			valid = find_program(command_line.c_str() + start, end - start);
+		}
 	}
 
 	if (!valid)
@@ -64,17 +82,39 @@ guint RunAction::search(const Query& query)
 		return G_MAXUINT;
 	}
 
-	m_command_line = query.raw_query();
+	// Set item text, which stays the same when arguments are retyped
+	if (m_command_line != command_line)
+	{
+		m_command_line = command_line;
 
-	// Set item text
-	const gchar* direction = (gtk_widget_get_default_direction() != GTK_TEXT_DIR_RTL) ? "\342\200\216" : "\342\200\217";
-	gchar* display_name = g_strdup_printf(_("Run %s"), m_command_line.c_str());
-	set_text(g_markup_printf_escaped("%s%s", direction, display_name));
-	set_tooltip(display_name);
-	g_free(display_name);
+		const gchar* direction = (gtk_widget_get_default_direction() != GTK_TEXT_DIR_RTL) ? "\342\200\216" : "\342\200\217";
+		gchar* display_name = g_strdup_printf(_("Run %s"), m_command_line.c_str());
+		set_text(g_markup_printf_escaped("%s%s", direction, display_name));
+		set_tooltip(display_name);
+		g_free(display_name);
+	}
 
-	// Sort after matches in names and before matches in executables
+	// Sort after matches in names and generic names, and before matches in
+	// every other field, such as keywords and commands
 	return 0xFFF;
 }
 
 //-----------------------------------------------------------------------------
+
+bool RunAction::find_program(const gchar* program, gsize length)
+{
+	// Only look in PATH when program changes, and not when its arguments do
+	if (m_program.compare(0, std::string::npos, program, length) == 0)
+	{
+		return m_program_found;
+	}
+	m_program.assign(program, length);
+
+	gchar* path = g_find_program_in_path(m_program.c_str());
+	m_program_found = path != NULL;
+	g_free(path);
+
+	return m_program_found;
+}
+
+//-----------------------------------------------------------------------------
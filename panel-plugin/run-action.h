@@ -43,8 +43,13 @@ public:
 	void run(GdkScreen* screen) const;
 	guint search(const Query& query);
 
+private:
+	bool find_program(const gchar* program, gsize length);
+
 private:
 	std::string m_command_line;
+	std::string m_program;
+	bool m_program_found;
 };
 
 }
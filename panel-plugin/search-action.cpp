@@ -20,6 +20,8 @@
 
 #include "query.h"
 
+#include <cstring>
+
 #include <libxfce4ui/libxfce4ui.h>
 
 using namespace ZorinMenuLite;
@@ -36,6 +38,8 @@ SearchAction::SearchAction(const gchar* name, const gchar* pattern, const gchar*
 	const gchar* direction = (gtk_widget_get_default_direction() != GTK_TEXT_DIR_RTL) ? "\342\200\216" : "\342\200\217";
 	set_text(g_markup_printf_escaped("%s%s", direction, m_name.c_str()));
 	set_tooltip(_("Search Action"));
+
+	find_prefixes();
 }
 
 //-----------------------------------------------------------------------------
@@ -67,10 +71,104 @@ guint SearchAction::search(const Query& query)
 
 //-----------------------------------------------------------------------------
 
+void SearchAction::find_prefixes()
+{
+	// Patterns anchored to the start with letters or digits, or a group of
+	// alternatives of only letters or digits, can only match text that
+	// begins with one of them
+	m_prefixes.clear();
+	if (m_pattern.empty() || (m_pattern[0] != '^'))
+	{
+		return;
+	}
+
+	std::string::size_type pos = 1;
+	const std::string::size_type length = m_pattern.length();
+	if ((pos < length) && (m_pattern[pos] == '('))
+	{
+		std::string::size_type start = ++pos;
+		for (; pos < length; ++pos)
+		{
+			gchar c = m_pattern[pos];
+			if ((c == '|') || (c == ')'))
+			{
+				m_prefixes.push_back(m_pattern.substr(start, pos - start));
+				start = pos + 1;
+				if (c == ')')
+				{
+					break;
+				}
+			}
+			else if (!g_ascii_isalnum(c))
+			{
+				break;
+			}
+		}
+
+		// Group may be optional or repeated
+		if ((pos == length) || (m_pattern[pos] != ')')
+				|| ((pos + 1 < length) && strchr("?*{", m_pattern[pos + 1])))
+		{
+			m_prefixes.clear();
+		}
+	}
+	else
+	{
+		std::string::size_type start = pos;
+		while ((pos < length) && g_ascii_isalnum(m_pattern[pos]))
+		{
+			++pos;
+		}
+
+		// Last character may be optional or repeated
+		if ((pos < length) && (pos > start) && strchr("?*{", m_pattern[pos]))
+		{
+			--pos;
+		}
+		if (pos > start)
+		{
+			m_prefixes.push_back(m_pattern.substr(start, pos - start));
+		}
+	}
+
+	// Alternatives outside the group, such as in "^abc|def", match text
+	// without the prefixes, so skip patterns with any later alternatives
+	if (m_pattern.find('|', pos) != std::string::npos)
+	{
+		m_prefixes.clear();
+	}
+
+	// Empty alternatives match any text
+	for (std::vector<std::string>::const_iterator i = m_prefixes.begin(), end = m_prefixes.end(); i != end; ++i)
+	{
+		if (i->empty())
+		{
+			m_prefixes.clear();
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
 guint SearchAction::match_regex(const gchar* haystack)
 {
 	guint found = G_MAXUINT;
 
+	// Skip text that can not match without allocating match info
+	if (!m_prefixes.empty())
+	{
+		std::vector<std::string>::const_iterator i = m_prefixes.begin(), end = m_prefixes.end();
+		while ((i != end) && !g_str_has_prefix(haystack, i->c_str()))
+		{
+			++i;
+		}
+		if (i == end)
+		{
+			return found;
+		}
+	}
+
 	if (!m_regex)
 	{
 		m_regex = g_regex_new(m_pattern.c_str(), G_REGEX_OPTIMIZE, GRegexMatchFlags(0), NULL);
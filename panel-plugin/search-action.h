@@ -22,6 +22,7 @@
 #include "element.h"
 
 #include <string>
+#include <vector>
 
 namespace ZorinMenuLite
 {
@@ -46,6 +47,7 @@ public:
 	guint search(const Query& query);
 
 private:
+	void find_prefixes();
 	guint match_regex(const gchar* haystack);
 
 private:
@@ -55,6 +57,7 @@ private:
 
 	std::string m_expanded_command;
 	GRegex* m_regex;
+	std::vector<std::string> m_prefixes;
 };
 
 }
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "search-corpus.h"
+
+#include "query.h"
+
+#include <cstring>
+
+using namespace ZorinMenuLite;
+
+// Sort matches by field: name, generic name, name spelled in Latin letters,
+// keywords, comment, actions, and command last; each is above every exact
+// tier of Query::Relevancy and below its approximate tiers
+static const guint field_relevancies[SearchCorpus::N_FIELDS] =
+{
+	0x400,
+	0x800,
+	0x1000,
+	0x2000,
+	0x4000,
+	0x8000,
+	0x10000
+};
+
+//-----------------------------------------------------------------------------
+
+template<typename T>
+static const T* get_data(const std::vector<T>& values, guint32 offset)
+{
+	return !values.empty() ? &values[0] + offset : NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+enum CharacterClass
+{
+	Space,
+	Separator,
+	Lowercase,
+	Uppercase,
+	Digit,
+	Other
+};
+
+}
+
+static CharacterClass get_class(gunichar c)
+{
+	if (g_unichar_isspace(c))
+	{
+		return Space;
+	}
+	else if ((c == '-') || (c == '_') || (c == '.') || (c == '/'))
+	{
+		return Separator;
+	}
+	else if (g_unichar_isdigit(c))
+	{
+		return Digit;
+	}
+	else if (g_unichar_isupper(c) || g_unichar_istitle(c))
+	{
+		return Uppercase;
+	}
+	else if (g_unichar_isalpha(c))
+	{
+		return Lowercase;
+	}
+	return Other;
+}
+
+//-----------------------------------------------------------------------------
+
+static bool begins_word(CharacterClass previous, CharacterClass current)
+{
+	if (previous == Space)
+	{
+		return true;
+	}
+	else if ((current == Space) || (current == Separator))
+	{
+		return false;
+	}
+
+	bool letter = (current == Lowercase) || (current == Uppercase);
+	return (previous == Separator)
+			|| ((previous == Lowercase) && (current == Uppercase))
+			|| ((previous == Digit) && letter)
+			|| (((previous == Lowercase) || (previous == Uppercase)) && (current == Digit));
+}
+
+//-----------------------------------------------------------------------------
+
+static void find_word_starts(const gchar* string, const gchar* text, std::vector<unsigned int>& word_starts)
+{
+	// Words begin at the start of text and after whitespace as before, and
+	// also after punctuation, between letters and digits, and where a
+	// lowercase letter is followed by an uppercase one, which is only known
+	// before casefolding; offsets are in text, the normalized string, so add
+	// the length that each character of string normalizes to
+	word_starts.clear();
+	const gsize length = strlen(text);
+	gsize offset = 0;
+	CharacterClass previous = Space;
+	for (const gchar* pos = string; *pos && (offset < length); )
+	{
+		const gchar* next = g_utf8_next_char(pos);
+		CharacterClass current = get_class(g_utf8_get_char(pos));
+		if (begins_word(previous, current))
+		{
+			word_starts.push_back(offset);
+		}
+		previous = current;
+
+		if ((string == text) || (static_cast<unsigned char>(*pos) < 0x80))
+		{
+			offset += next - pos;
+		}
+		else
+		{
+			offset += Query::normalize(std::string(pos, next).c_str()).length();
+		}
+		pos = next;
+	}
+
+	// Characters that change when normalized together with their neighbours
+	// leave offsets out of place, so find words in text instead
+	if ((offset != length) && (string != text))
+	{
+		find_word_starts(text, text, word_starts);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+SearchCorpus::SearchCorpus() :
+	m_size(0)
+{
+	clear();
+}
+
+//-----------------------------------------------------------------------------
+
+guint SearchCorpus::add(const std::string* texts)
+{
+	// Combine signatures of fields to skip launchers with one comparison
+	m_signatures.resize(m_signatures.size() + signatures_size, 0);
+	uint64_t* signatures = &m_signatures[m_size * signatures_size];
+	for (int i = 0; i < N_FIELDS; ++i)
+	{
+		signatures[i + 1] = add_text(m_fields[i], texts[i]);
+		signatures[0] |= signatures[i + 1];
+	}
+	return m_size++;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchCorpus::clear()
+{
+	for (int i = 0; i < N_FIELDS; ++i)
+	{
+		reset(m_fields[i]);
+	}
+	std::vector<uint64_t>().swap(m_signatures);
+	std::vector<unsigned int>().swap(m_word_starts);
+	m_size = 0;
+}
+
+//-----------------------------------------------------------------------------
+
+SearchText SearchCorpus::get_text(guint id, Field field) const
+{
+	const Texts& texts = m_fields[field];
+	const Offsets& offsets = texts.offsets[id];
+	const Offsets& next = texts.offsets[id + 1];
+
+	SearchText text;
+	text.m_text = texts.text.data() + offsets.text;
+	text.m_length = next.text - offsets.text - 1;
+	if (next.folded_text != offsets.folded_text)
+	{
+		text.m_folded_text = texts.folded_text.data() + offsets.folded_text;
+		text.m_folded_length = next.folded_text - offsets.folded_text - 1;
+	}
+	else
+	{
+		text.m_folded_text = text.m_text;
+		text.m_folded_length = text.m_length;
+	}
+	text.m_word_starts = get_data(texts.word_starts, offsets.word_starts);
+	text.m_word_count = next.word_starts - offsets.word_starts;
+	text.m_word_start_bits = get_data(texts.word_start_bits, 0);
+	text.m_word_start_bit = offsets.text;
+	text.m_codepoints = get_data(texts.codepoints, offsets.codepoints);
+	text.m_codepoint_count = next.codepoints - offsets.codepoints;
+	text.m_initials = get_data(texts.initials, offsets.initials);
+	text.m_initial_indices = get_data(texts.initial_indices, offsets.initials);
+	text.m_initial_count = next.initials - offsets.initials;
+	text.m_signature = m_signatures[(id * signatures_size) + field + 1];
+	return text;
+}
+
+//-----------------------------------------------------------------------------
+
+guint SearchCorpus::search(guint id, const Query& query) const
+{
+	// Find which fields have every character of query from the signatures
+	// of launcher, and only read the text of those fields
+	const uint64_t* signatures = &m_signatures[id * signatures_size];
+	const uint64_t needed = query.query_signature();
+	if ((signatures[0] & needed) != needed)
+	{
+		return G_MAXUINT;
+	}
+
+	for (int i = 0; i < N_FIELDS; ++i)
+	{
+		if ((signatures[i + 1] & needed) != needed)
+		{
+			continue;
+		}
+
+		guint match = query.match(get_text(id, Field(i)));
+		if (match != G_MAXUINT)
+		{
+			return match | field_relevancies[i];
+		}
+	}
+	return G_MAXUINT;
+}
+
+//-----------------------------------------------------------------------------
+
+guint SearchCorpus::search_approximate(guint id, const Query& query) const
+{
+	// Only check names for typos
+	for (int i = Name; i <= GenericName; ++i)
+	{
+		guint match = query.match_approximate(get_text(id, Field(i)));
+		if (match != G_MAXUINT)
+		{
+			return match | field_relevancies[i];
+		}
+	}
+	return G_MAXUINT;
+}
+
+//-----------------------------------------------------------------------------
+
+uint64_t SearchCorpus::add_text(Texts& texts, const std::string& string)
+{
+	const guint32 offset = texts.offsets.back().text;
+	texts.text += Query::normalize(string.c_str());
+	texts.text += '\0';
+
+	const gchar* text = texts.text.c_str() + offset;
+	std::string folded_text = Query::fold(text);
+	if (!folded_text.empty())
+	{
+		texts.folded_text += folded_text;
+		texts.folded_text += '\0';
+	}
+	uint64_t signature = Query::signature(!folded_text.empty() ? folded_text.c_str() : text);
+
+	// Find each character that begins a word
+	texts.word_start_bits.resize((texts.text.length() + 63) / 64, 0);
+	find_word_starts(string.c_str(), text, m_word_starts);
+	std::vector<unsigned int>::const_iterator word_start = m_word_starts.begin(), word_starts_end = m_word_starts.end();
+	unsigned int codepoints = 0;
+	for (const gchar* pos = text; *pos; pos = g_utf8_next_char(pos))
+	{
+		gunichar c = g_utf8_get_char(pos);
+		const unsigned int offset = pos - text;
+		while ((word_start != word_starts_end) && (*word_start < offset))
+		{
+			++word_start;
+		}
+		if ((word_start != word_starts_end) && (*word_start == offset))
+		{
+			texts.word_starts.push_back(offset);
+			const guint32 bit = pos - texts.text.c_str();
+			texts.word_start_bits[bit / 64] |= uint64_t(1) << (bit % 64);
+
+			if (!g_unichar_isspace(c))
+			{
+				texts.initials.push_back(c);
+				texts.initial_indices.push_back(codepoints);
+			}
+		}
+
+		texts.codepoints.push_back(c);
+		++codepoints;
+	}
+
+	Offsets end = { guint32(texts.text.length()), guint32(texts.folded_text.length()),
+			guint32(texts.word_starts.size()), guint32(texts.codepoints.size()), guint32(texts.initials.size()) };
+	texts.offsets.push_back(end);
+
+	return signature;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchCorpus::reset(Texts& texts)
+{
+	std::string().swap(texts.text);
+	std::string().swap(texts.folded_text);
+	std::vector<unsigned int>().swap(texts.word_starts);
+	std::vector<uint64_t>().swap(texts.word_start_bits);
+	std::vector<unsigned int>().swap(texts.codepoints);
+	std::vector<unsigned int>().swap(texts.initials);
+	std::vector<unsigned int>().swap(texts.initial_indices);
+
+	Offsets begin = { 0, 0, 0, 0, 0 };
+	texts.offsets.assign(1, begin);
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZORIN_MENU_LITE_SEARCH_CORPUS_H
+#define ZORIN_MENU_LITE_SEARCH_CORPUS_H
+
+#include "search-text.h"
+
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+namespace ZorinMenuLite
+{
+
+class Query;
+
+// Search text of every launcher, with each field stored in a few shared
+// arrays indexed by launcher id, so that scoring reads memory in order
+// instead of following pointers to each launcher
+class SearchCorpus
+{
+public:
+	enum Field
+	{
+		Name,
+		GenericName,
+		Romanized,
+		Keywords,
+		Comment,
+		Actions,
+		Command,
+		N_FIELDS
+	};
+
+	SearchCorpus();
+
+	guint size() const
+	{
+		return m_size;
+	}
+
+	// Appends the text of each field of a launcher, and returns its id
+	guint add(const std::string* texts);
+	void clear();
+
+	SearchText get_text(guint id, Field field) const;
+
+	// Returns the relevancy of the launcher with id, with matches in names
+	// sorting first and matches in commands sorting last
+	guint search(guint id, const Query& query) const;
+	guint search_approximate(guint id, const Query& query) const;
+
+private:
+	// Offsets of an id into the arrays of a field, with one more at the end
+	// so that each id ends where the next one begins
+	struct Offsets
+	{
+		guint32 text;
+		guint32 folded_text;
+		guint32 word_starts;
+		guint32 codepoints;
+		guint32 initials;
+	};
+
+	// Texts are followed by a null byte, and folded text is only stored
+	// when it is different from text; each byte of text has a bit that is
+	// set if a word begins there
+	struct Texts
+	{
+		std::string text;
+		std::string folded_text;
+		std::vector<unsigned int> word_starts;
+		std::vector<uint64_t> word_start_bits;
+		std::vector<unsigned int> codepoints;
+		std::vector<unsigned int> initials;
+		std::vector<unsigned int> initial_indices;
+		std::vector<Offsets> offsets;
+	};
+
+	uint64_t add_text(Texts& texts, const std::string& string);
+
+	// Signatures of a launcher are stored together, starting with the
+	// combined signature of its fields
+	enum
+	{
+		signatures_size = N_FIELDS + 1
+	};
+	static void reset(Texts& texts);
+
+private:
+	Texts m_fields[N_FIELDS];
+	std::vector<uint64_t> m_signatures;
+	std::vector<unsigned int> m_word_starts;
+	guint m_size;
+};
+
+}
+
+#endif // ZORIN_MENU_LITE_SEARCH_CORPUS_H
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "search-index.h"
+
+#include "launcher.h"
+#include "query.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <cstring>
+
+using namespace ZorinMenuLite;
+
+//-----------------------------------------------------------------------------
+
+static bool is_shorter(const std::vector<guint>* lhs, const std::vector<guint>* rhs)
+{
+	return lhs->size() < rhs->size();
+}
+
+//-----------------------------------------------------------------------------
+
+static void collect_characters(const gchar* string, std::vector<gunichar>& characters)
+{
+	for (const gchar* pos = string; *pos; pos = g_utf8_next_char(pos))
+	{
+		gunichar c = g_utf8_get_char(pos);
+		if (!g_unichar_isspace(c))
+		{
+			characters.push_back(c);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Compares only as many bytes as the query has, so that every word start
+// beginning with the query is equal to it
+class PrefixCompare
+{
+public:
+	explicit PrefixCompare(const std::string& query) :
+		m_length(query.length())
+	{
+	}
+
+	template<typename T>
+	bool operator()(const T& word_start, const gchar* query) const
+	{
+		return strncmp(word_start.key, query, m_length) < 0;
+	}
+
+	template<typename T>
+	bool operator()(const gchar* query, const T& word_start) const
+	{
+		return strncmp(query, word_start.key, m_length) < 0;
+	}
+
+private:
+	std::string::size_type m_length;
+};
+
+}
+
+//-----------------------------------------------------------------------------
+
+SearchIndex::SearchIndex()
+{
+}
+
+//-----------------------------------------------------------------------------
+
+SearchIndex::~SearchIndex()
+{
+	clear();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchIndex::build(const std::vector<Element*>& items)
+{
+	clear();
+
+	// Copy search text of launchers into corpus
+	std::string texts[SearchCorpus::N_FIELDS];
+	for (std::vector<Element*>::const_iterator i = items.begin(), end = items.end(); i != end; ++i)
+	{
+		if (!*i || ((*i)->get_type() != Launcher::Type))
+		{
+			continue;
+		}
+
+		Launcher* launcher = static_cast<Launcher*>(*i);
+		m_launchers.push_back(launcher);
+
+		launcher->get_search_texts(texts);
+		m_corpus.add(texts);
+	}
+
+	std::vector<gunichar> characters;
+	for (guint id = 0, end = m_corpus.size(); id < end; ++id)
+	{
+		// Add launcher once to the posting of each character in its search
+		// text without accents; folding only removes characters, so a query
+		// that matches the search text has all of its folded characters in it
+		characters.clear();
+		for (int field = 0; field < SearchCorpus::N_FIELDS; ++field)
+		{
+			collect_characters(m_corpus.get_text(id, SearchCorpus::Field(field)).folded_text(), characters);
+		}
+		std::sort(characters.begin(), characters.end());
+		characters.erase(std::unique(characters.begin(), characters.end()), characters.end());
+
+		for (std::vector<gunichar>::const_iterator c = characters.begin(), c_end = characters.end(); c != c_end; ++c)
+		{
+			add_posting(*c, id);
+		}
+
+		// Add each word start of name
+		SearchText name = m_corpus.get_text(id, SearchCorpus::Name);
+		for (unsigned int i = 0, count = name.word_count(); i < count; ++i)
+		{
+			unsigned int offset = name.word_starts()[i];
+			WordStart word_start = { name.text() + offset, id, offset };
+			m_word_starts.push_back(word_start);
+		}
+	}
+
+	std::sort(m_word_starts.begin(), m_word_starts.end(), &SearchIndex::word_start_less_than);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchIndex::clear()
+{
+	m_launchers.clear();
+	m_corpus.clear();
+	for (int i = 0; i < 128; ++i)
+	{
+		std::vector<guint>().swap(m_ascii_postings[i]);
+	}
+	m_postings.clear();
+	std::vector<WordStart>().swap(m_word_starts);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchIndex::find_candidates(const Query& query, std::vector<guint>& candidates, CandidateBuffers& buffers) const
+{
+	candidates.clear();
+
+	// Every match tier needs each character of the query in the haystack,
+	// so only launchers in the posting of every query character can match
+	std::vector<gunichar>& characters = buffers.characters;
+	characters.clear();
+	collect_characters(query.folded_query().c_str(), characters);
+	std::sort(characters.begin(), characters.end());
+	characters.erase(std::unique(characters.begin(), characters.end()), characters.end());
+
+	if (characters.empty())
+	{
+		for (guint i = 0, end = m_launchers.size(); i < end; ++i)
+		{
+			candidates.push_back(i);
+		}
+		return;
+	}
+
+	std::vector<const std::vector<guint>*>& postings = buffers.postings;
+	postings.clear();
+	for (std::vector<gunichar>::const_iterator c = characters.begin(), end = characters.end(); c != end; ++c)
+	{
+		const std::vector<guint>* posting = find_posting(*c);
+		if (!posting)
+		{
+			return;
+		}
+		postings.push_back(posting);
+	}
+
+	// Intersect starting from the rarest character
+	std::sort(postings.begin(), postings.end(), &is_shorter);
+	candidates = *postings.front();
+
+	std::vector<guint>& intersection = buffers.intersection;
+	for (std::vector<const std::vector<guint>*>::size_type i = 1, end = postings.size(); (i < end) && !candidates.empty(); ++i)
+	{
+		intersection.clear();
+		std::set_intersection(candidates.begin(), candidates.end(),
+				postings[i]->begin(), postings[i]->end(),
+				std::back_inserter(intersection));
+		candidates.swap(intersection);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchIndex::find_prefix_matches(const Query& query, std::vector<guint>& ids, std::vector<guint>& relevancies) const
+{
+	const std::string& needle = query.query();
+	if (needle.empty())
+	{
+		return;
+	}
+
+	PrefixCompare compare(needle);
+	std::pair<std::vector<WordStart>::const_iterator, std::vector<WordStart>::const_iterator> range =
+			std::equal_range(m_word_starts.begin(), m_word_starts.end(), needle.c_str(), compare);
+
+	for (std::vector<WordStart>::const_iterator i = range.first; i != range.second; ++i)
+	{
+		SearchText name = m_corpus.get_text(i->id, SearchCorpus::Name);
+
+		// Match tiers are the same as in Query::match, and matches in names
+		// sort first as in SearchCorpus::search
+		guint relevancy;
+		if (i->offset == 0)
+		{
+			relevancy = ((name.length() == needle.length()) ? Query::MatchEqual : Query::MatchPrefix) | 0x400;
+		}
+		else if (strstr(name.text(), needle.c_str()) == (name.text() + i->offset))
+		{
+			relevancy = Query::MatchWordPrefix | 0x400;
+		}
+		else
+		{
+			continue;
+		}
+
+		if (relevancies[i->id] == G_MAXUINT)
+		{
+			ids.push_back(i->id);
+			relevancies[i->id] = relevancy;
+		}
+		else
+		{
+			relevancies[i->id] = std::min(relevancies[i->id], relevancy);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchIndex::add_posting(gunichar c, guint id)
+{
+	if (c < 128)
+	{
+		m_ascii_postings[c].push_back(id);
+	}
+	else
+	{
+		m_postings[c].push_back(id);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+const std::vector<guint>* SearchIndex::find_posting(gunichar c) const
+{
+	if (c < 128)
+	{
+		return !m_ascii_postings[c].empty() ? &m_ascii_postings[c] : NULL;
+	}
+
+	std::map<gunichar, std::vector<guint> >::const_iterator i = m_postings.find(c);
+	return (i != m_postings.end()) ? &i->second : NULL;
+}
+
+//-----------------------------------------------------------------------------
+
+bool SearchIndex::word_start_less_than(const WordStart& lhs, const WordStart& rhs)
+{
+	return strcmp(lhs.key, rhs.key) < 0;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZORIN_MENU_LITE_SEARCH_INDEX_H
+#define ZORIN_MENU_LITE_SEARCH_INDEX_H
+
+#include "search-corpus.h"
+
+#include <map>
+#include <vector>
+
+#include <glib.h>
+
+namespace ZorinMenuLite
+{
+
+class Element;
+class Launcher;
+class Query;
+
+class SearchIndex
+{
+public:
+	SearchIndex();
+	~SearchIndex();
+
+	const std::vector<Launcher*>& get_launchers() const
+	{
+		return m_launchers;
+	}
+
+	// Search text of launchers, with the same ids as get_launchers
+	const SearchCorpus& get_corpus() const
+	{
+		return m_corpus;
+	}
+
+	void build(const std::vector<Element*>& items);
+	void clear();
+
+	// Vectors used by find_candidates, which callers keep to reuse them
+	struct CandidateBuffers
+	{
+		std::vector<gunichar> characters;
+		std::vector<const std::vector<guint>*> postings;
+		std::vector<guint> intersection;
+	};
+
+	// Fills candidates with the ids of every launcher that contains all of
+	// the characters in query, in the order the launchers were indexed
+	void find_candidates(const Query& query, std::vector<guint>& candidates, CandidateBuffers& buffers) const;
+
+	// Appends the ids of launchers whose name begins with query or has query
+	// as its first occurrence at a word start, and stores the relevancy
+	// SearchCorpus::search would return for them in relevancies
+	void find_prefix_matches(const Query& query, std::vector<guint>& ids, std::vector<guint>& relevancies) const;
+
+private:
+	void add_posting(gunichar c, guint id);
+	const std::vector<guint>* find_posting(gunichar c) const;
+
+	struct WordStart
+	{
+		const gchar* key;
+		guint id;
+		guint offset;
+	};
+
+	static bool word_start_less_than(const WordStart& lhs, const WordStart& rhs);
+
+private:
+	std::vector<Launcher*> m_launchers;
+	SearchCorpus m_corpus;
+	std::vector<WordStart> m_word_starts;
+	std::vector<guint> m_ascii_postings[128];
+	std::map<gunichar, std::vector<guint> > m_postings;
+};
+
+}
+
+#endif // ZORIN_MENU_LITE_SEARCH_INDEX_H
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "search-model.h"
+
+#include "element.h"
+#include "launcher.h"
+#include "launcher-view.h"
+
+#include <algorithm>
+
+using namespace ZorinMenuLite;
+
+//-----------------------------------------------------------------------------
+
+// Rows are stored in the object, so that they stay valid for as long as a
+// view holds a reference to the model
+struct ZorinMenuLiteSearchModel
+{
+	GObject parent;
+	std::vector<Element*>* rows;
+	gint stamp;
+};
+
+struct ZorinMenuLiteSearchModelClass
+{
+	GObjectClass parent_class;
+};
+
+static void zorinmenulite_search_model_tree_model_init(GtkTreeModelIface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(ZorinMenuLiteSearchModel, zorinmenulite_search_model, G_TYPE_OBJECT,
+		G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, zorinmenulite_search_model_tree_model_init))
+
+//-----------------------------------------------------------------------------
+
+static ZorinMenuLiteSearchModel* get_object(GtkTreeModel* model)
+{
+	return reinterpret_cast<ZorinMenuLiteSearchModel*>(model);
+}
+
+//-----------------------------------------------------------------------------
+
+static bool set_iter(ZorinMenuLiteSearchModel* object, GtkTreeIter* iter, gint index)
+{
+	if ((index < 0) || (index >= gint(object->rows->size())))
+	{
+		iter->stamp = 0;
+		return false;
+	}
+
+	iter->stamp = object->stamp;
+	iter->user_data = GINT_TO_POINTER(index);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static void zorinmenulite_search_model_init(ZorinMenuLiteSearchModel* object)
+{
+	object->rows = new std::vector<Element*>;
+	object->stamp = g_random_int();
+}
+
+//-----------------------------------------------------------------------------
+
+static void zorinmenulite_search_model_finalize(GObject* object)
+{
+	delete reinterpret_cast<ZorinMenuLiteSearchModel*>(object)->rows;
+
+	G_OBJECT_CLASS(zorinmenulite_search_model_parent_class)->finalize(object);
+}
+
+//-----------------------------------------------------------------------------
+
+static void zorinmenulite_search_model_class_init(ZorinMenuLiteSearchModelClass* klass)
+{
+	G_OBJECT_CLASS(klass)->finalize = zorinmenulite_search_model_finalize;
+}
+
+//-----------------------------------------------------------------------------
+
+static GtkTreeModelFlags get_flags(GtkTreeModel*)
+{
+	return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+//-----------------------------------------------------------------------------
+
+static gint get_n_columns(GtkTreeModel*)
+{
+	return LauncherView::N_COLUMNS;
+}
+
+//-----------------------------------------------------------------------------
+
+static GType get_column_type(GtkTreeModel*, gint column)
+{
+	return (column == LauncherView::COLUMN_LAUNCHER) ? G_TYPE_POINTER : G_TYPE_STRING;
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean get_iter(GtkTreeModel* model, GtkTreeIter* iter, GtkTreePath* path)
+{
+	if (gtk_tree_path_get_depth(path) != 1)
+	{
+		iter->stamp = 0;
+		return false;
+	}
+	return set_iter(get_object(model), iter, gtk_tree_path_get_indices(path)[0]);
+}
+
+//-----------------------------------------------------------------------------
+
+static GtkTreePath* get_path(GtkTreeModel*, GtkTreeIter* iter)
+{
+	return gtk_tree_path_new_from_indices(GPOINTER_TO_INT(iter->user_data), -1);
+}
+
+//-----------------------------------------------------------------------------
+
+static void get_value(GtkTreeModel* model, GtkTreeIter* iter, gint column, GValue* value)
+{
+	Element* element = get_object(model)->rows->at(GPOINTER_TO_INT(iter->user_data));
+
+	// Strings of launchers belong to them, which outlive the rows showing
+	// them; actions replace their strings when matched, so those are copied
+	const gchar* text = NULL;
+	switch (column)
+	{
+	case LauncherView::COLUMN_ICON:
+		text = element->get_icon();
+		break;
+
+	case LauncherView::COLUMN_TEXT:
+		text = element->get_text();
+		break;
+
+	case LauncherView::COLUMN_TOOLTIP:
+		text = element->get_tooltip();
+		break;
+
+	default:
+		g_value_init(value, G_TYPE_POINTER);
+		g_value_set_pointer(value, element);
+		return;
+	}
+
+	g_value_init(value, G_TYPE_STRING);
+	if (element->get_type() == Launcher::Type)
+	{
+		g_value_set_static_string(value, text);
+	}
+	else
+	{
+		g_value_set_string(value, text);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_next(GtkTreeModel* model, GtkTreeIter* iter)
+{
+	return set_iter(get_object(model), iter, GPOINTER_TO_INT(iter->user_data) + 1);
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_previous(GtkTreeModel* model, GtkTreeIter* iter)
+{
+	return set_iter(get_object(model), iter, GPOINTER_TO_INT(iter->user_data) - 1);
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_nth_child(GtkTreeModel* model, GtkTreeIter* iter, GtkTreeIter* parent, gint n)
+{
+	if (parent)
+	{
+		iter->stamp = 0;
+		return false;
+	}
+	return set_iter(get_object(model), iter, n);
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_children(GtkTreeModel* model, GtkTreeIter* iter, GtkTreeIter* parent)
+{
+	return iter_nth_child(model, iter, parent, 0);
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_has_child(GtkTreeModel*, GtkTreeIter*)
+{
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+static gint iter_n_children(GtkTreeModel* model, GtkTreeIter* iter)
+{
+	return !iter ? get_object(model)->rows->size() : 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static gboolean iter_parent(GtkTreeModel*, GtkTreeIter* iter, GtkTreeIter*)
+{
+	iter->stamp = 0;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+
+static void zorinmenulite_search_model_tree_model_init(GtkTreeModelIface* iface)
+{
+	iface->get_flags = get_flags;
+	iface->get_n_columns = get_n_columns;
+	iface->get_column_type = get_column_type;
+	iface->get_iter = get_iter;
+	iface->get_path = get_path;
+	iface->get_value = get_value;
+	iface->iter_next = iter_next;
+	iface->iter_previous = iter_previous;
+	iface->iter_children = iter_children;
+	iface->iter_has_child = iter_has_child;
+	iface->iter_n_children = iter_n_children;
+	iface->iter_nth_child = iter_nth_child;
+	iface->iter_parent = iter_parent;
+}
+
+//-----------------------------------------------------------------------------
+
+SearchModel::SearchModel()
+{
+	m_model = GTK_TREE_MODEL(g_object_new(zorinmenulite_search_model_get_type(), NULL));
+	m_rows = get_object(m_model)->rows;
+}
+
+//-----------------------------------------------------------------------------
+
+SearchModel::~SearchModel()
+{
+	g_object_unref(m_model);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchModel::set_rows(const std::vector<Element*>& elements)
+{
+	m_old_sorted = *m_rows;
+	std::sort(m_old_sorted.begin(), m_old_sorted.end());
+	m_new_sorted = elements;
+	std::sort(m_new_sorted.begin(), m_new_sorted.end());
+
+	// Remove rows that are not shown anymore
+	for (gint i = m_rows->size() - 1; i >= 0; --i)
+	{
+		if (!std::binary_search(m_new_sorted.begin(), m_new_sorted.end(), (*m_rows)[i]))
+		{
+			remove_row(i);
+		}
+	}
+
+	// Move remaining rows into the same order as elements
+	m_kept.clear();
+	for (std::vector<Element*>::const_iterator i = elements.begin(), end = elements.end(); i != end; ++i)
+	{
+		if (std::binary_search(m_old_sorted.begin(), m_old_sorted.end(), *i))
+		{
+			m_kept.push_back(*i);
+		}
+	}
+
+	if (m_kept != *m_rows)
+	{
+		m_positions.clear();
+		for (gint i = 0, end = m_rows->size(); i < end; ++i)
+		{
+			Position position = { (*m_rows)[i], i };
+			m_positions.push_back(position);
+		}
+		std::sort(m_positions.begin(), m_positions.end());
+
+		m_new_order.clear();
+		for (std::vector<Element*>::const_iterator i = m_kept.begin(), end = m_kept.end(); i != end; ++i)
+		{
+			Position position = { *i, 0 };
+			m_new_order.push_back(std::lower_bound(m_positions.begin(), m_positions.end(), position)->index);
+		}
+
+		*m_rows = m_kept;
+		++get_object(m_model)->stamp;
+
+		GtkTreePath* path = gtk_tree_path_new();
+		gtk_tree_model_rows_reordered(m_model, path, NULL, &m_new_order[0]);
+		gtk_tree_path_free(path);
+	}
+
+	// Add new rows, and refresh kept actions because their text depends
+	// on the query
+	for (gint i = 0, end = elements.size(); i < end; ++i)
+	{
+		Element* element = elements[i];
+		if (!std::binary_search(m_old_sorted.begin(), m_old_sorted.end(), element))
+		{
+			insert_row(i, element);
+		}
+		else if (element->get_type() != Launcher::Type)
+		{
+			GtkTreeIter iter;
+			set_iter(get_object(m_model), &iter, i);
+			GtkTreePath* path = gtk_tree_path_new_from_indices(i, -1);
+			gtk_tree_model_row_changed(m_model, path, &iter);
+			gtk_tree_path_free(path);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchModel::append_row(Element* element)
+{
+	insert_row(m_rows->size(), element);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchModel::clear()
+{
+	for (gint i = m_rows->size() - 1; i >= 0; --i)
+	{
+		remove_row(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchModel::insert_row(gint index, Element* element)
+{
+	m_rows->insert(m_rows->begin() + index, element);
+	++get_object(m_model)->stamp;
+
+	GtkTreeIter iter;
+	set_iter(get_object(m_model), &iter, index);
+	GtkTreePath* path = gtk_tree_path_new_from_indices(index, -1);
+	gtk_tree_model_row_inserted(m_model, path, &iter);
+	gtk_tree_path_free(path);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchModel::remove_row(gint index)
+{
+	m_rows->erase(m_rows->begin() + index);
+	++get_object(m_model)->stamp;
+
+	GtkTreePath* path = gtk_tree_path_new_from_indices(index, -1);
+	gtk_tree_model_row_deleted(m_model, path);
+	gtk_tree_path_free(path);
+}
+
+//-----------------------------------------------------------------------------
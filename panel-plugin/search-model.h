@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZORIN_MENU_LITE_SEARCH_MODEL_H
+#define ZORIN_MENU_LITE_SEARCH_MODEL_H
+
+#include <vector>
+
+#include <gtk/gtk.h>
+
+namespace ZorinMenuLite
+{
+
+class Element;
+
+// List model that reads the columns of LauncherView straight from the
+// elements of its rows, instead of copying them like a GtkListStore
+class SearchModel
+{
+public:
+	SearchModel();
+	~SearchModel();
+
+	GtkTreeModel* get_model() const
+	{
+		return m_model;
+	}
+
+	// Changes the rows to elements, only signalling the rows that were
+	// removed, added, or moved
+	void set_rows(const std::vector<Element*>& elements);
+	void append_row(Element* element);
+	void clear();
+
+private:
+	void insert_row(gint index, Element* element);
+	void remove_row(gint index);
+
+	struct Position
+	{
+		Element* element;
+		gint index;
+
+		bool operator<(const Position& position) const
+		{
+			return element < position.element;
+		}
+	};
+
+private:
+	GtkTreeModel* m_model;
+	std::vector<Element*>* m_rows;
+	std::vector<Element*> m_old_sorted;
+	std::vector<Element*> m_new_sorted;
+	std::vector<Element*> m_kept;
+	std::vector<Position> m_positions;
+	std::vector<gint> m_new_order;
+};
+
+}
+
+#endif // ZORIN_MENU_LITE_SEARCH_MODEL_H
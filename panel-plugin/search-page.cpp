@@ -18,6 +18,7 @@
 
 #include "search-page.h"
 
+#include "launch-history.h"
 #include "launcher.h"
 #include "launcher-view.h"
 #include "search-action.h"
@@ -34,11 +35,34 @@ using namespace ZorinMenuLite;
 //-----------------------------------------------------------------------------
 
 SearchPage::SearchPage(Window* window) :
-	Page(window)
+	Page(window),
+	m_index(NULL),
+	m_launch_serial(0),
+	m_pool(NULL),
+	m_shards_remaining(0),
+	m_search_cancellable(NULL),
+	m_spare_cancellable(NULL),
+	m_running_cancellable(NULL),
+	m_search_idle(0),
+	m_search_generation(0),
+	m_running_generation(0),
+	m_search_running(false),
+	m_pending_clear(true),
+	m_ranked_count(0),
+	m_results_sorted(0),
+	m_results_shown(0),
+	m_cached_results(NULL)
 {
 	get_view()->set_selection_mode(GTK_SELECTION_BROWSE);
 	m_search_action = new SearchAction(_("Open URI"), "^(file|http|https):\\/\\/(.*)$", "exo-open \\0");
 
+	g_mutex_init(&m_shards_mutex);
+	g_cond_init(&m_shards_cond);
+
+	g_mutex_init(&m_search_mutex);
+	g_cond_init(&m_search_cond);
+
+	g_signal_connect_slot(gtk_scrollable_get_vadjustment(GTK_SCROLLABLE(get_view()->get_widget())), "value-changed", &SearchPage::show_more_results, this);
 	g_signal_connect_slot(window->get_search_entry(), "icon-release", &SearchPage::clear_search, this);
 	g_signal_connect_slot(window->get_search_entry(), "key-press-event", &SearchPage::cancel_search, this);
 	g_signal_connect_slot<GtkEntry*>(window->get_search_entry(), "activate", &SearchPage::activate_search, this);
@@ -48,6 +72,25 @@ SearchPage::SearchPage(Window* window) :
 
 SearchPage::~SearchPage()
 {
+	wait_for_search();
+	if (m_search_idle)
+	{
+		g_source_remove(m_search_idle);
+	}
+	if (m_spare_cancellable)
+	{
+		g_object_unref(m_spare_cancellable);
+	}
+	g_cond_clear(&m_search_cond);
+	g_mutex_clear(&m_search_mutex);
+
+	if (m_pool)
+	{
+		g_thread_pool_free(m_pool, false, true);
+	}
+	g_cond_clear(&m_shards_cond);
+	g_mutex_clear(&m_shards_mutex);
+
 	unset_menu_items();
 	delete m_search_action;
 }
@@ -55,89 +98,411 @@ SearchPage::~SearchPage()
 //-----------------------------------------------------------------------------
 
 void SearchPage::set_filter(const gchar* filter)
+{
+	// Only run the newest search of a burst of changes once idle
+	++m_search_generation;
+	m_pending_clear = !filter;
+	m_pending_filter = filter ? filter : "";
+	if (!m_search_idle && !m_search_cancellable)
+	{
+		m_search_idle = g_idle_add(&SearchPage::start_search_slot, this);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::start_search()
 {
 	// Clear search results for empty filter
-	if (!filter)
+	if (m_pending_clear)
 	{
 		m_query.clear();
 		m_matches.clear();
+		m_cached_results = NULL;
+		m_prefix_filter.clear();
+		m_prefix_results.clear();
 		return;
 	}
 
 	// Make sure this is a new search
-	std::string query(filter);
-	if (m_query.raw_query() == query)
+	if (m_query.raw_query() == m_pending_filter)
 	{
 		return;
 	}
 
-	// Reset search results if new search does not start with previous search
-	if (m_query.raw_query().empty() || !g_str_has_prefix(filter, m_query.raw_query().c_str()))
+	// Search in thread, keeping the generation to check if it is stale
+	m_search_filter = m_pending_filter;
+	m_running_generation = m_search_generation;
+
+	// Show best matches before starting thread, which uses the same buffers
+	show_prefix_results();
+
+	// Reuse the cancellable of the last search if it finished uncancelled
+	m_search_running = true;
+	if (m_spare_cancellable)
 	{
-		m_matches.clear();
-		m_matches.push_back(&m_run_action);
-		for (std::vector<Launcher*>::size_type i = 0, end = m_launchers.size(); i < end; ++i)
+		m_search_cancellable = m_spare_cancellable;
+		m_spare_cancellable = NULL;
+	}
+	else
+	{
+		m_search_cancellable = g_cancellable_new();
+	}
+
+	GTask* task = g_task_new(NULL, m_search_cancellable, &SearchPage::search_finished_slot, this);
+	g_task_set_task_data(task, this, NULL);
+	g_task_run_in_thread(task, &SearchPage::search_slot);
+	g_object_unref(task);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::finish_search()
+{
+	m_spare_cancellable = m_search_cancellable;
+	m_search_cancellable = NULL;
+
+	// Drop stale results and run the newest search instead
+	if (m_running_generation != m_search_generation)
+	{
+		start_search();
+		if (m_search_cancellable || m_pending_clear)
 		{
-			m_matches.push_back(m_launchers[i]);
+			return;
 		}
 	}
-	else if (std::find(m_matches.begin(), m_matches.end(), &m_run_action) == m_matches.end())
+	show_results();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::wait_for_search()
+{
+	if (!m_search_cancellable)
+	{
+		return;
+	}
+
+	// Cancelled searches are ignored when they finish
+	g_cancellable_cancel(m_search_cancellable);
+	g_object_unref(m_search_cancellable);
+	m_search_cancellable = NULL;
+
+	g_mutex_lock(&m_search_mutex);
+	while (m_search_running)
 	{
-		m_matches.insert(m_matches.begin(), &m_run_action);
+		g_cond_wait(&m_search_cond, &m_search_mutex);
+	}
+	g_mutex_unlock(&m_search_mutex);
+}
+
+//-----------------------------------------------------------------------------
+
+bool SearchPage::search_cancelled() const
+{
+	// Searches run in the main thread can not be cancelled
+	return m_running_cancellable && g_cancellable_is_cancelled(m_running_cancellable);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::update_results()
+{
+	// Cached results are ranked by how often launchers were run before;
+	// forgotten results are kept to store later results without allocating
+	guint launch_serial = get_window()->get_launch_history()->get_serial();
+	if (m_launch_serial != launch_serial)
+	{
+		m_launch_serial = launch_serial;
+		m_spare_results.splice(m_spare_results.end(), m_history);
+	}
+
+	// Forget cached results of searches that new search does not start with
+	const std::string& query = m_search_filter;
+	while (!m_history.empty() && !g_str_has_prefix(query.c_str(), m_history.back().query.c_str()))
+	{
+		m_spare_results.splice(m_spare_results.end(), m_history, --m_history.end());
 	}
 	m_query.set(query);
+	m_cached_results = NULL;
+
+	// Only launchers are matched here; actions change their text when
+	// matched, so they are matched in the main thread when shown
+	if (!m_history.empty() && (m_history.back().query == query))
+	{
+		// Reuse cached results when characters were removed from search,
+		// which are shown from the cache without copying them to matches
+		m_cached_results = &m_history.back();
+		return;
+	}
+
+	// Reuse results of a recent search for the same text, which may have
+	// been typed in an earlier popup of the menu
+	std::list<Results>::iterator recent = m_recent.begin();
+	for (std::list<Results>::iterator end = m_recent.end(); recent != end; ++recent)
+	{
+		if (recent->query == m_query.query())
+		{
+			break;
+		}
+	}
+
+	if (recent != m_recent.end())
+	{
+		m_recent.splice(m_recent.begin(), m_recent, recent);
+		restore_matches(*recent);
 
-	// Create search results
-	std::vector<Match> search_action_matches;
-	search_action_matches.reserve(1);
+		// Rank again if launchers have been run since
+		if (recent->launch_serial != m_launch_serial)
+		{
+			get_window()->get_launch_history()->get_scores(m_launchers, m_frecency);
+			for (std::vector<Match>::iterator i = m_matches.begin(), end = m_matches.end(); i != end; ++i)
+			{
+				i->set_frecency(m_frecency[i->id()]);
+			}
+			rank_matches();
+			store_matches(*recent, m_query.query());
+		}
+	}
+	else
+	{
+		update_matches();
+		add_approximate_matches();
+
+		// Do not cache results of a cancelled search, and make the next
+		// search for the same text run again
+		if (search_cancelled())
+		{
+			m_query.clear();
+			m_matches.clear();
+			m_ranked_count = 0;
+			return;
+		}
+
+		if (m_recent.size() == max_recent)
+		{
+			m_recent.splice(m_recent.begin(), m_recent, --m_recent.end());
+		}
+		else
+		{
+			m_recent.push_front(Results());
+		}
+		store_matches(m_recent.front(), m_query.query());
+	}
+
+	// Cache results to narrow down as more characters are typed
+	if (m_history.size() == max_history)
+	{
+		m_history.splice(m_history.end(), m_history, m_history.begin());
+	}
+	else if (!m_spare_results.empty())
+	{
+		m_history.splice(m_history.end(), m_spare_results, m_spare_results.begin());
+	}
+	else
+	{
+		m_history.push_back(Results());
+	}
+	store_matches(m_history.back(), query);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::restore_matches(const Results& results)
+{
+	m_matches = results.matches;
+	m_ranked_count = results.ranked;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::match_search_action(const Query& query)
+{
+	m_search_action_matches.clear();
 	Match match(m_search_action);
-	match.update(m_query);
+	match.update(query);
 	if (!Match::invalid(match))
 	{
-		search_action_matches.push_back(match);
+		m_search_action_matches.push_back(match);
 	}
-	std::stable_sort(search_action_matches.begin(), search_action_matches.end());
-	std::reverse(search_action_matches.begin(), search_action_matches.end());
+}
 
-	for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+//-----------------------------------------------------------------------------
+
+void SearchPage::add_actions()
+{
+	// Match actions, which change their text, while the search thread is
+	// not running, as rows in the view read their text; the search action
+	// was already matched when the results of this search began showing,
+	// unless they were skipped
+	if (m_prefix_query.raw_query() != m_query.raw_query())
 	{
-		m_matches[i].update(m_query);
+		match_search_action(m_query);
 	}
-	m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(), &Match::invalid), m_matches.end());
-	std::stable_sort(m_matches.begin(), m_matches.end());
-
-	// Show search results
-	GtkListStore* store = gtk_list_store_new(
-			LauncherView::N_COLUMNS,
-			G_TYPE_STRING,
-			G_TYPE_STRING,
-			G_TYPE_STRING,
-			G_TYPE_POINTER);
-	Element* element;
-	for (std::vector<Match>::size_type i = 0, end = search_action_matches.size(); i < end; ++i)
-	{
-		element = search_action_matches[i].element();
-		gtk_list_store_insert_with_values(
-				store, NULL, G_MAXINT,
-				LauncherView::COLUMN_ICON, element->get_icon(),
-				LauncherView::COLUMN_TEXT, element->get_text(),
-				LauncherView::COLUMN_TOOLTIP, element->get_tooltip(),
-				LauncherView::COLUMN_LAUNCHER, element,
-				-1);
+
+	Match run_match(&m_run_action);
+	run_match.update(m_query);
+	if (Match::invalid(run_match))
+	{
+		return;
 	}
-	for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+
+	// Run action is only ranked if it sorts before the unranked results
+	std::vector<Match>::iterator ranked_end = m_results.begin() + m_results_sorted;
+	std::vector<Match>::iterator i = std::upper_bound(m_results.begin(), ranked_end, run_match);
+	if ((i != ranked_end) || (ranked_end == m_results.end()))
+	{
+		++m_results_sorted;
+	}
+	m_results.insert(i, run_match);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::store_matches(Results& results, const std::string& query)
+{
+	// Only launchers are cached, as actions are added when shown
+	results.query = query;
+	results.matches = m_matches;
+	results.ranked = m_ranked_count;
+	results.launch_serial = m_launch_serial;
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::show_prefix_results()
+{
+	m_prefix_filter = m_search_filter;
+	m_prefix_results.clear();
+	m_rows.clear();
+
+	// Look up launchers whose names begin with the query at a word start,
+	// which sort before every other match and can be shown while the rest
+	// are searched
+	m_prefix_query.set(m_search_filter);
+	if (m_index)
+	{
+		m_index->find_prefix_matches(m_prefix_query, m_prefix_ids, m_prefix_relevancies);
+	}
+	if (!m_prefix_ids.empty())
+	{
+		LaunchHistory* launch_history = get_window()->get_launch_history();
+		if (m_launch_serial != launch_history->get_serial())
+		{
+			launch_history->get_scores(m_launchers, m_frecency);
+		}
+
+		std::sort(m_prefix_ids.begin(), m_prefix_ids.end());
+		for (std::vector<guint>::size_type i = 0, end = m_prefix_ids.size(); i < end; ++i)
+		{
+			guint id = m_prefix_ids[i];
+			Match match(m_launchers[id], id, m_frecency[id]);
+			match.set_relevancy(m_prefix_relevancies[id]);
+			m_prefix_results.push_back(match);
+			m_prefix_relevancies[id] = G_MAXUINT;
+		}
+		m_prefix_ids.clear();
+
+		sort_matches(m_prefix_results.begin(), m_prefix_results.end(), m_results_buffer);
+		if (m_prefix_results.size() > max_ranked_matches)
+		{
+			m_prefix_results.resize(max_ranked_matches);
+		}
+	}
+
+	match_search_action(m_prefix_query);
+	for (std::vector<Match>::size_type i = 0, end = m_search_action_matches.size(); i < end; ++i)
+	{
+		m_rows.push_back(m_search_action_matches[i].element());
+	}
+	for (std::vector<Match>::size_type i = 0, end = m_prefix_results.size(); i < end; ++i)
+	{
+		m_rows.push_back(m_prefix_results[i].element());
+	}
+
+	// Keep showing previous results until there is something to replace them
+	if (m_rows.empty())
+	{
+		m_prefix_filter.clear();
+		return;
+	}
+
+	m_model.set_rows(m_rows);
+	if (get_view()->get_model() != m_model.get_model())
+	{
+		get_view()->set_model(m_model.get_model());
+	}
+
+	GtkTreePath* path = gtk_tree_path_new_first();
+	get_view()->select_path(path);
+	get_view()->scroll_to_path(path);
+	gtk_tree_path_free(path);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::show_results()
+{
+	// Keep a copy of results, because the next search replaces matches in a
+	// worker thread while more results may still be shown
+	if (m_cached_results)
+	{
+		m_results = m_cached_results->matches;
+		m_results_sorted = m_cached_results->ranked;
+	}
+	else
 	{
-		element = m_matches[i].element();
-		gtk_list_store_insert_with_values(
-				store, NULL, G_MAXINT,
-				LauncherView::COLUMN_ICON, element->get_icon(),
-				LauncherView::COLUMN_TEXT, element->get_text(),
-				LauncherView::COLUMN_TOOLTIP, element->get_tooltip(),
-				LauncherView::COLUMN_LAUNCHER, element,
-				-1);
+		m_results = m_matches;
+		m_results_sorted = m_ranked_count;
+	}
+	add_actions();
+
+	// Move rows that were shown while searching to the front in the same
+	// order, so that adding the other results does not move them
+	bool streamed = !m_prefix_filter.empty() && (m_prefix_filter == m_search_filter);
+	if (streamed)
+	{
+		std::vector<Match>::iterator front = m_results.begin();
+		for (std::vector<Match>::const_iterator i = m_prefix_results.begin(), end = m_prefix_results.end(); i != end; ++i)
+		{
+			std::vector<Match>::iterator match = std::find(front, m_results.end(), *i);
+			if (match == m_results.end())
+			{
+				continue;
+			}
+			if (std::vector<Match>::size_type(match - m_results.begin()) >= m_results_sorted)
+			{
+				++m_results_sorted;
+			}
+			std::rotate(front, match, match + 1);
+			++front;
+		}
+	}
+	m_prefix_filter.clear();
+	m_prefix_results.clear();
+	m_results_shown = m_results_sorted;
+
+	// Show search results, leaving unranked matches until scrolled to
+	m_rows.clear();
+	for (std::vector<Match>::size_type i = 0, end = m_search_action_matches.size(); i < end; ++i)
+	{
+		m_rows.push_back(m_search_action_matches[i].element());
+	}
+	for (std::vector<Match>::size_type i = 0; i < m_results_shown; ++i)
+	{
+		m_rows.push_back(m_results[i].element());
+	}
+	m_model.set_rows(m_rows);
+	if (get_view()->get_model() != m_model.get_model())
+	{
+		get_view()->set_model(m_model.get_model());
+	}
+
+	// Leave selection alone if it may have been moved since rows were shown
+	if (streamed)
+	{
+		return;
 	}
-	get_view()->set_model(GTK_TREE_MODEL(store));
-	g_object_unref(store);
 
 	// Find first result
 	GtkTreeIter iter;
@@ -155,41 +520,457 @@ void SearchPage::set_filter(const gchar* filter)
 
 //-----------------------------------------------------------------------------
 
-void SearchPage::set_menu_items(GtkTreeModel* model)
+void SearchPage::show_more_results(GtkAdjustment* adjustment)
 {
-	// loop over every single item in model
-	GtkTreeIter iter;
-	bool valid = gtk_tree_model_get_iter_first(model, &iter);
-	while (valid)
+	if (m_results_shown >= m_results.size())
 	{
-		Launcher* launcher = NULL;
-		gtk_tree_model_get(model, &iter, LauncherView::COLUMN_LAUNCHER, &launcher, -1);
-		if (launcher)
+		return;
+	}
+
+	// Wait until scrolled to within a page of the last shown result
+	gdouble page_size = gtk_adjustment_get_page_size(adjustment);
+	if ((gtk_adjustment_get_value(adjustment) + page_size) < (gtk_adjustment_get_upper(adjustment) - page_size))
+	{
+		return;
+	}
+
+	// Unranked matches keep the order they were found in, so sorting them
+	// stably places them as if every match had been sorted at once
+	if (m_results_sorted < m_results.size())
+	{
+		sort_matches(m_results.begin() + m_results_sorted, m_results.end(), m_results_buffer);
+		m_results_sorted = m_results.size();
+	}
+
+	std::vector<Match>::size_type end = std::min(m_results_shown + max_ranked_matches, m_results.size());
+	for (; m_results_shown < end; ++m_results_shown)
+	{
+		m_model.append_row(m_results[m_results_shown].element());
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::update_matches()
+{
+	if (m_history.empty())
+	{
+		// Break ties with how often and how recently launchers were run
+		get_window()->get_launch_history()->get_scores(m_launchers, m_frecency);
+
+		// Only check launchers that contain every character of the query
+		m_matches.clear();
+		if (m_index)
+		{
+			m_index->find_candidates(m_query, m_candidates, m_candidate_buffers);
+			for (std::vector<guint>::size_type i = 0, end = m_candidates.size(); i < end; ++i)
+			{
+				guint id = m_candidates[i];
+				m_matches.push_back(Match(m_launchers[id], id, m_frecency[id]));
+			}
+		}
+	}
+	else
+	{
+		// Narrow results of longest cached search that new search starts with
+		m_matches = m_history.back().matches;
+	}
+
+	if (search_cancelled())
+	{
+		return;
+	}
+
+	// Look up launchers whose names begin with the query at a word start
+	if (m_index)
+	{
+		m_index->find_prefix_matches(m_query, m_prefix_ids, m_prefix_relevancies);
+	}
+
+	// Score launchers, which are the only elements in matches; each shard
+	// only writes to its own range of matches, so results are in the same
+	// order as when scored serially
+	std::vector<Match>::size_type count = m_matches.size();
+	if (m_pool && (count >= parallel_threshold))
+	{
+		std::vector<Shard>::size_type shards = m_shards.size();
+		m_shards_remaining = shards - 1;
+		for (std::vector<Shard>::size_type i = 0; i < shards; ++i)
+		{
+			m_shards[i].page = this;
+			m_shards[i].begin = (i * count) / shards;
+			m_shards[i].end = ((i + 1) * count) / shards;
+			if (i > 0)
+			{
+				g_thread_pool_push(m_pool, &m_shards[i], NULL);
+			}
+		}
+
+		score_matches(m_shards[0].begin, m_shards[0].end);
+
+		g_mutex_lock(&m_shards_mutex);
+		while (m_shards_remaining > 0)
+		{
+			g_cond_wait(&m_shards_cond, &m_shards_mutex);
+		}
+		g_mutex_unlock(&m_shards_mutex);
+	}
+	else
+	{
+		score_matches(0, count);
+	}
+
+	for (std::vector<guint>::size_type i = 0, end = m_prefix_ids.size(); i < end; ++i)
+	{
+		m_prefix_relevancies[m_prefix_ids[i]] = G_MAXUINT;
+	}
+	m_prefix_ids.clear();
+	if (search_cancelled())
+	{
+		return;
+	}
+	m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(), &Match::invalid), m_matches.end());
+	rank_matches();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::rank_matches()
+{
+	m_ranked_count = m_matches.size();
+	if (m_ranked_count <= max_ranked_matches)
+	{
+		sort_matches(m_matches.begin(), m_matches.end(), m_matches_buffer);
+		return;
+	}
+	m_ranked_count = max_ranked_matches;
+
+	// Find relevancy of last match that is shown first
+	m_keys.clear();
+	for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+	{
+		m_keys.push_back(m_matches[i].key());
+	}
+	std::nth_element(m_keys.begin(), m_keys.begin() + (max_ranked_matches - 1), m_keys.end());
+	guint64 threshold = m_keys[max_ranked_matches - 1];
+
+	std::vector<Match>::size_type ties = max_ranked_matches;
+	for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+	{
+		if (m_matches[i].key() < threshold)
+		{
+			--ties;
+		}
+	}
+
+	// Move best matches to the front without changing the order of matches
+	// with equal relevancy, and only sort those
+	m_unranked.clear();
+	std::vector<Match>::iterator ranked = m_matches.begin();
+	for (std::vector<Match>::const_iterator i = m_matches.begin(), end = m_matches.end(); i != end; ++i)
+	{
+		guint64 key = i->key();
+		if ((key < threshold) || ((key == threshold) && (ties > 0)))
+		{
+			if (key == threshold)
+			{
+				--ties;
+			}
+			*ranked = *i;
+			++ranked;
+		}
+		else
+		{
+			m_unranked.push_back(*i);
+		}
+	}
+	std::copy(m_unranked.begin(), m_unranked.end(), ranked);
+	sort_matches(m_matches.begin(), ranked, m_matches_buffer);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::sort_matches(std::vector<Match>::iterator begin, std::vector<Match>::iterator end, std::vector<Match>& buffer)
+{
+	// Counting costs more than comparing for few matches
+	const std::vector<Match>::size_type count = end - begin;
+	if (count < 64)
+	{
+		insertion_sort(begin, end);
+		return;
+	}
+
+	// Relevancies fit in 19 bits, and launchers that were never run have the
+	// same frecency, so count matches by 9 and then 10 bits of relevancy at
+	// a time, along with whether they were run, which sorts before not
+	// being run
+	guint low_counts[1024] = { 0 };
+	guint high_counts[1024] = { 0 };
+	guint relevancies = 0;
+	for (std::vector<Match>::iterator i = begin; i != end; ++i)
+	{
+		guint64 key = i->key();
+		guint relevancy = key >> 32;
+		relevancies |= relevancy;
+		++low_counts[((relevancy & 0x1FF) << 1) | (guint(key) == G_MAXUINT)];
+		++high_counts[(relevancy >> 9) & 0x3FF];
+	}
+	if (relevancies >= (1 << 19))
+	{
+		std::stable_sort(begin, end);
+		return;
+	}
+
+	// Place matches by the lower bits and then by the higher bits, skipping
+	// either if all matches are equal in it; each pass keeps matches that
+	// are equal in it in order, so equal matches stay in order
+	buffer.resize(count);
+	Match* source = &*begin;
+	Match* target = &buffer[0];
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		guint* counts = (pass == 0) ? low_counts : high_counts;
+		const guint buckets = 1024;
+		guint first = get_bucket(*source, pass);
+		if (counts[first] == count)
+		{
+			continue;
+		}
+
+		for (guint i = 0, offset = 0; i < buckets; ++i)
+		{
+			guint bucket_count = counts[i];
+			counts[i] = offset;
+			offset += bucket_count;
+		}
+
+		for (std::vector<Match>::size_type i = 0; i < count; ++i)
+		{
+			target[counts[get_bucket(source[i], pass)]++] = source[i];
+		}
+		std::swap(source, target);
+	}
+	if (source != &*begin)
+	{
+		std::copy(source, source + count, begin);
+	}
+
+	// Sort launchers that were run by frecency, which are few
+	std::vector<Match>::iterator run = begin;
+	while (run != end)
+	{
+		std::vector<Match>::iterator run_end = run + 1;
+		if (guint(run->key()) != G_MAXUINT)
+		{
+			while ((run_end != end) && (guint(run_end->key()) != G_MAXUINT) && ((run_end->key() >> 32) == (run->key() >> 32)))
+			{
+				++run_end;
+			}
+			if ((run_end - run) < 64)
+			{
+				insertion_sort(run, run_end);
+			}
+			else
+			{
+				std::stable_sort(run, run_end);
+			}
+		}
+		run = run_end;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::insertion_sort(std::vector<Match>::iterator begin, std::vector<Match>::iterator end)
+{
+	// Sorts few matches stably without the buffer that std::stable_sort
+	// allocates even for a single match
+	for (std::vector<Match>::iterator i = begin; i != end; ++i)
+	{
+		Match match = *i;
+		std::vector<Match>::iterator j = i;
+		for (; (j != begin) && (match < *(j - 1)); --j)
+		{
+			*j = *(j - 1);
+		}
+		*j = match;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+guint SearchPage::get_bucket(const Match& match, int pass)
+{
+	guint64 key = match.key();
+	guint relevancy = key >> 32;
+	return (pass == 0) ? (((relevancy & 0x1FF) << 1) | (guint(key) == G_MAXUINT)) : ((relevancy >> 9) & 0x3FF);
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::score_matches(gsize begin, gsize end)
+{
+	for (gsize i = begin; i < end; ++i)
+	{
+		// Stop scoring once the search is cancelled, checking now and then
+		if ((((i - begin) % 1024) == 0) && search_cancelled())
+		{
+			return;
+		}
+
+		guint id = m_matches[i].id();
+		if (m_prefix_relevancies[id] != G_MAXUINT)
+		{
+			m_matches[i].set_relevancy(m_prefix_relevancies[id]);
+		}
+		else
+		{
+			m_matches[i].set_relevancy(m_index->get_corpus().search(id, m_query));
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::add_approximate_matches()
+{
+	// Only look for typos when there are few exact matches
+	if ((m_matches.size() >= min_exact_matches) || search_cancelled())
+	{
+		return;
+	}
+	m_exact_ids.clear();
+	for (std::vector<Match>::size_type i = 0, end = m_matches.size(); i < end; ++i)
+	{
+		m_exact_ids.push_back(m_matches[i].id());
+	}
+	std::sort(m_exact_ids.begin(), m_exact_ids.end());
+
+	for (std::vector<Launcher*>::size_type i = 0, end = m_launchers.size(); i < end; ++i)
+	{
+		if (std::binary_search(m_exact_ids.begin(), m_exact_ids.end(), i))
+		{
+			continue;
+		}
+		if (((i % 1024) == 0) && search_cancelled())
 		{
-			m_launchers.push_back(launcher);
+			return;
 		}
-		valid = gtk_tree_model_iter_next(model, &iter);
+
+		Match match(m_launchers[i], i, m_frecency[i]);
+		match.set_relevancy(m_index->get_corpus().search_approximate(i, m_query));
+		if (!Match::invalid(match))
+		{
+			m_matches.push_back(match);
+		}
+	}
+
+	// Approximate matches are less relevant than every exact match, so
+	// ranking again keeps the exact matches first and only sorts as many
+	// approximate matches as are shown before scrolling
+	rank_matches();
+}
+
+//-----------------------------------------------------------------------------
+
+void SearchPage::set_menu_items(const SearchIndex* index)
+{
+	// Text may have been searched while the menu was loading, so wait for
+	// that search to stop before replacing what it reads
+	wait_for_search();
+	if (m_search_idle)
+	{
+		g_source_remove(m_search_idle);
+		m_search_idle = 0;
 	}
+	m_query.clear();
+	m_spare_results.splice(m_spare_results.end(), m_history);
+	m_recent.clear();
+	m_cached_results = NULL;
+
+	// Launchers are indexed in the same order as the all items category
+	m_index = index;
+	m_launchers = index->get_launchers();
+	m_prefix_relevancies.assign(m_launchers.size(), G_MAXUINT);
+	m_frecency.assign(m_launchers.size(), 0);
 
 	get_view()->unset_model();
 
 	m_matches.clear();
-	m_matches.reserve(m_launchers.size() + 1);
+	m_matches.reserve(m_launchers.size());
+
+	// Score large lists of launchers in worker threads, with the calling
+	// thread scoring the first shard; the threads are shared with the rest
+	// of the process, and only started once a menu is this large
+	guint threads = g_get_num_processors();
+	if (!m_pool && (threads > 1) && (m_launchers.size() >= parallel_threshold))
+	{
+		m_pool = g_thread_pool_new(&SearchPage::score_shard_slot, NULL, threads - 1, false, NULL);
+		m_shards.resize(threads);
+	}
+
+	// Search the new launchers for text typed while loading
+	if (!m_pending_clear)
+	{
+		m_search_idle = g_idle_add(&SearchPage::start_search_slot, this);
+	}
 }
 
 //-----------------------------------------------------------------------------
 
 void SearchPage::unset_menu_items()
 {
+	// Launchers are about to be freed, so stop searching them
+	wait_for_search();
+	if (m_search_idle)
+	{
+		g_source_remove(m_search_idle);
+		m_search_idle = 0;
+	}
+	m_query.clear();
+
+	m_index = NULL;
 	m_launchers.clear();
+	m_history.clear();
+	m_spare_results.clear();
+	m_recent.clear();
+	m_cached_results = NULL;
+	m_candidates.clear();
+	m_exact_ids.clear();
+	m_prefix_relevancies.clear();
+	m_prefix_filter.clear();
+	m_prefix_results.clear();
 	m_matches.clear();
+	m_ranked_count = 0;
+	m_results.clear();
+	m_results_sorted = 0;
+	m_results_shown = 0;
 	get_view()->unset_model();
+	m_model.clear();
 }
 
 //-----------------------------------------------------------------------------
 
 void SearchPage::activate_search()
 {
+	// Make sure results are for the current text of search entry
+	if (m_search_idle || m_search_cancellable)
+	{
+		wait_for_search();
+		if (m_search_idle)
+		{
+			g_source_remove(m_search_idle);
+			m_search_idle = 0;
+		}
+
+		if (!m_pending_clear && (m_query.raw_query() != m_pending_filter))
+		{
+			m_search_filter = m_pending_filter;
+			update_results();
+		}
+		show_results();
+	}
+
 	GtkTreePath* path = get_view()->get_selected_path();
 	if (path)
 	{
@@ -22,7 +22,10 @@
 #include "page.h"
 #include "query.h"
 #include "run-action.h"
+#include "search-index.h"
+#include "search-model.h"
 
+#include <list>
 #include <string>
 #include <vector>
 
@@ -38,10 +41,22 @@ public:
 	~SearchPage();
 
 	void set_filter(const gchar* filter);
-	void set_menu_items(GtkTreeModel* model);
+	void set_menu_items(const SearchIndex* index);
 	void unset_menu_items();
 
 private:
+	void start_search();
+	void finish_search();
+	void wait_for_search();
+	bool search_cancelled() const;
+	void update_results();
+	void show_prefix_results();
+	void show_results();
+	void show_more_results(GtkAdjustment* adjustment);
+	void update_matches();
+	void rank_matches();
+	void score_matches(gsize begin, gsize end);
+	void add_approximate_matches();
 	void activate_search();
 	void clear_search(GtkEntry* entry, GtkEntryIconPosition icon_pos, GdkEvent*);
 	gboolean cancel_search(GtkWidget* widget, GdkEvent* event);
@@ -49,15 +64,95 @@ private:
 private:
 	SearchAction* m_search_action;
 	Query m_query;
+	const SearchIndex* m_index;
 	std::vector<Launcher*> m_launchers;
+	std::vector<guint> m_candidates;
+	SearchIndex::CandidateBuffers m_candidate_buffers;
+	std::vector<guint> m_exact_ids;
+	std::vector<guint> m_prefix_ids;
+	std::vector<guint> m_prefix_relevancies;
+	std::vector<guint> m_frecency;
+	guint m_launch_serial;
 	RunAction m_run_action;
 
+	struct Shard
+	{
+		SearchPage* page;
+		gsize begin;
+		gsize end;
+	};
+	std::vector<Shard> m_shards;
+	GThreadPool* m_pool;
+	guint m_shards_remaining;
+	GMutex m_shards_mutex;
+	GCond m_shards_cond;
+
+	GCancellable* m_search_cancellable;
+	GCancellable* m_spare_cancellable;
+	GCancellable* m_running_cancellable;
+	guint m_search_idle;
+	guint m_search_generation;
+	guint m_running_generation;
+	bool m_search_running;
+	GMutex m_search_mutex;
+	GCond m_search_cond;
+	bool m_pending_clear;
+	std::string m_pending_filter;
+	std::string m_search_filter;
+
+	static gboolean start_search_slot(gpointer user_data)
+	{
+		SearchPage* page = reinterpret_cast<SearchPage*>(user_data);
+		page->m_search_idle = 0;
+		page->start_search();
+		return G_SOURCE_REMOVE;
+	}
+
+	static void search_slot(GTask* task, gpointer, gpointer task_data, GCancellable* cancellable)
+	{
+		SearchPage* page = reinterpret_cast<SearchPage*>(task_data);
+		page->m_running_cancellable = cancellable;
+		page->update_results();
+		page->m_running_cancellable = NULL;
+
+		g_mutex_lock(&page->m_search_mutex);
+		page->m_search_running = false;
+		g_cond_signal(&page->m_search_cond);
+		g_mutex_unlock(&page->m_search_mutex);
+
+		g_task_return_boolean(task, true);
+	}
+
+	static void search_finished_slot(GObject*, GAsyncResult* result, gpointer user_data)
+	{
+		// Search page may be gone if search was cancelled
+		if (!g_cancellable_is_cancelled(g_task_get_cancellable(G_TASK(result))))
+		{
+			reinterpret_cast<SearchPage*>(user_data)->finish_search();
+		}
+	}
+
+	static void score_shard_slot(gpointer data, gpointer)
+	{
+		Shard* shard = reinterpret_cast<Shard*>(data);
+		shard->page->score_matches(shard->begin, shard->end);
+
+		g_mutex_lock(&shard->page->m_shards_mutex);
+		if (--shard->page->m_shards_remaining == 0)
+		{
+			g_cond_signal(&shard->page->m_shards_cond);
+		}
+		g_mutex_unlock(&shard->page->m_shards_mutex);
+	}
+
 	class Match
 	{
 	public:
-		Match(Element* element = NULL) :
+		Match(Element* element = NULL, guint id = G_MAXUINT, guint frecency = 0) :
 			m_element(element),
-			m_relevancy(G_MAXINT)
+			m_id(id),
+			m_relevancy(G_MAXINT),
+			m_frecency(frecency)
 		{
 		}
 
@@ -66,9 +161,20 @@ private:
 			return m_element;
 		}
 
+		guint id() const
+		{
+			return m_id;
+		}
+
+		// Sorts by relevancy, and then by most frecent launchers first
+		guint64 key() const
+		{
+			return (guint64(m_relevancy) << 32) | (G_MAXUINT - m_frecency);
+		}
+
 		bool operator<(const Match& match) const
 		{
-			return m_relevancy < match.m_relevancy;
+			return key() < match.key();
 		}
 
 		bool operator==(const Match& match) const
@@ -82,6 +188,16 @@ private:
 			m_relevancy = m_element->search(query);
 		}
 
+		void set_relevancy(guint relevancy)
+		{
+			m_relevancy = relevancy;
+		}
+
+		void set_frecency(guint frecency)
+		{
+			m_frecency = frecency;
+		}
+
 		static bool invalid(const Match& match)
 		{
 			return match.m_relevancy == G_MAXUINT;
@@ -89,9 +205,53 @@ private:
 
 	private:
 		Element* m_element;
+		guint m_id;
 		guint m_relevancy;
+		guint m_frecency;
 	};
+	static void sort_matches(std::vector<Match>::iterator begin, std::vector<Match>::iterator end, std::vector<Match>& buffer);
+	static void insertion_sort(std::vector<Match>::iterator begin, std::vector<Match>::iterator end);
+	static guint get_bucket(const Match& match, int pass);
+
 	std::vector<Match> m_matches;
+	std::vector<Match>::size_type m_ranked_count;
+	std::vector<Match> m_matches_buffer;
+	std::vector<Match> m_unranked;
+	std::vector<guint64> m_keys;
+	std::vector<Match> m_search_action_matches;
+
+	Query m_prefix_query;
+	std::string m_prefix_filter;
+	std::vector<Match> m_prefix_results;
+
+	std::vector<Match> m_results;
+	std::vector<Match> m_results_buffer;
+	std::vector<Match>::size_type m_results_sorted;
+	std::vector<Match>::size_type m_results_shown;
+	std::vector<Element*> m_rows;
+	SearchModel m_model;
+
+	struct Results
+	{
+		std::string query;
+		std::vector<Match> matches;
+		std::vector<Match>::size_type ranked;
+		guint launch_serial;
+	};
+	void restore_matches(const Results& results);
+	void match_search_action(const Query& query);
+	void add_actions();
+	void store_matches(Results& results, const std::string& query);
+
+	std::list<Results> m_history;
+	static const std::list<Results>::size_type max_history = 16;
+	std::list<Results> m_spare_results;
+	std::list<Results> m_recent;
+	static const std::list<Results>::size_type max_recent = 32;
+	const Results* m_cached_results;
+	static const std::vector<Match>::size_type min_exact_matches = 10;
+	static const std::vector<Match>::size_type max_ranked_matches = 50;
+	static const std::vector<Match>::size_type parallel_threshold = 2048;
 };
 
 }
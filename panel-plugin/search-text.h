@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZORIN_MENU_LITE_SEARCH_TEXT_H
+#define ZORIN_MENU_LITE_SEARCH_TEXT_H
+
+#include <cstddef>
+
+#include <stdint.h>
+
+namespace ZorinMenuLite
+{
+
+class SearchCorpus;
+
+// Normalized text of one field of a launcher, which points into the arrays
+// of a SearchCorpus instead of owning its own copies
+class SearchText
+{
+public:
+	SearchText() :
+		m_text(""),
+		m_length(0),
+		m_folded_text(""),
+		m_folded_length(0),
+		m_word_starts(NULL),
+		m_word_count(0),
+		m_word_start_bits(NULL),
+		m_word_start_bit(0),
+		m_codepoints(NULL),
+		m_codepoint_count(0),
+		m_initials(NULL),
+		m_initial_indices(NULL),
+		m_initial_count(0),
+		m_signature(0)
+	{
+	}
+
+	bool empty() const
+	{
+		return !m_length;
+	}
+
+	unsigned int length() const
+	{
+		return m_length;
+	}
+
+	const char* text() const
+	{
+		return m_text;
+	}
+
+	bool has_folded_text() const
+	{
+		return m_folded_text != m_text;
+	}
+
+	// Text without accents, for matching regardless of accents
+	const char* folded_text() const
+	{
+		return m_folded_text;
+	}
+
+	unsigned int folded_length() const
+	{
+		return m_folded_length;
+	}
+
+	// Byte offsets in text of where words begin, which are split at
+	// whitespace, punctuation, digits, and lowercase to uppercase changes
+	const unsigned int* word_starts() const
+	{
+		return m_word_starts;
+	}
+
+	unsigned int word_count() const
+	{
+		return m_word_count;
+	}
+
+	bool is_start_word(unsigned int pos) const
+	{
+		const unsigned int bit = m_word_start_bit + pos;
+		return (pos < m_length) && ((m_word_start_bits[bit / 64] >> (bit % 64)) & 1);
+	}
+
+	const unsigned int* codepoints() const
+	{
+		return m_codepoints;
+	}
+
+	unsigned int codepoint_count() const
+	{
+		return m_codepoint_count;
+	}
+
+	// First character of each word, and its index in codepoints
+	const unsigned int* initials() const
+	{
+		return m_initials;
+	}
+
+	const unsigned int* initial_indices() const
+	{
+		return m_initial_indices;
+	}
+
+	unsigned int initial_count() const
+	{
+		return m_initial_count;
+	}
+
+	// Characters in text without accents, from Query::signature
+	uint64_t signature() const
+	{
+		return m_signature;
+	}
+
+private:
+	const char* m_text;
+	unsigned int m_length;
+	const char* m_folded_text;
+	unsigned int m_folded_length;
+	const unsigned int* m_word_starts;
+	unsigned int m_word_count;
+	const uint64_t* m_word_start_bits;
+	unsigned int m_word_start_bit;
+	const unsigned int* m_codepoints;
+	unsigned int m_codepoint_count;
+	const unsigned int* m_initials;
+	const unsigned int* m_initial_indices;
+	unsigned int m_initial_count;
+	uint64_t m_signature;
+
+	friend class SearchCorpus;
+};
+
+}
+
+#endif // ZORIN_MENU_LITE_SEARCH_TEXT_H
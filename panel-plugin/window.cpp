@@ -23,6 +23,7 @@
 #include "category.h"
 #include "category-view.h"
 #include "command.h"
+#include "launch-history.h"
 #include "launcher-view.h"
 #include "plugin.h"
 #include "place-button.h"
@@ -166,6 +167,9 @@ ZorinMenuLite::Window::Window(Plugin* plugin) :
 	gtk_entry_set_icon_activatable(m_search_entry, GTK_ENTRY_ICON_PRIMARY, false);
 	g_signal_connect_slot<GtkEditable*>(m_search_entry, "changed", &Window::search, this);
 
+	// Load how often applications were launched
+	m_launch_history = new LaunchHistory;
+
 	// Create applications
 	m_applications = new ApplicationsPage(this);
 
@@ -288,6 +292,7 @@ ZorinMenuLite::Window::~Window()
 	delete m_applications;
 	delete m_categories;
 	delete m_search_results;
+	delete m_launch_history;
 
 	delete m_user_button;
 
@@ -475,7 +480,7 @@ void ZorinMenuLite::Window::set_categories(const std::vector<Category*>& categor
 
 void ZorinMenuLite::Window::set_items()
 {
-	m_search_results->set_menu_items(m_applications->get_view()->get_model());
+	m_search_results->set_menu_items(m_applications->get_search_index());
 }
 
 //-----------------------------------------------------------------------------
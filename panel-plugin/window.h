@@ -36,6 +36,7 @@ class UserButton;
 class SearchPage;
 class Category;
 class Command;
+class LaunchHistory;
 
 class Window
 {
@@ -65,6 +66,11 @@ public:
 		return m_applications;
 	}
 
+	LaunchHistory* get_launch_history() const
+	{
+		return m_launch_history;
+	}
+
 	void hide();
 	void show(const Position position);
 	void on_context_menu_destroyed();
@@ -121,6 +127,7 @@ private:
 
 	GtkEntry* m_search_entry;
 
+	LaunchHistory* m_launch_history;
 	SearchPage* m_search_results;
 	ApplicationsPage* m_applications;
 	CategoryPage* m_categories;
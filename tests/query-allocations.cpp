@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Zorin OS Technologies Ltd.
+ *
+ * This library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "launcher.h"
+#include "query.h"
+#include "search-corpus.h"
+#include "search-index.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <glib/gstdio.h>
+
+using namespace ZorinMenuLite;
+
+//-----------------------------------------------------------------------------
+
+// Count allocations made while replaying keystrokes, including those made
+// by GLib, by replacing the allocation functions of the C library
+extern "C"
+{
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+
+static bool counting = false;
+static unsigned int allocations = 0;
+
+void* malloc(size_t size) __THROW
+{
+	if (counting)
+	{
+		++allocations;
+	}
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW
+{
+	if (counting)
+	{
+		++allocations;
+	}
+	return __libc_calloc(count, size);
+}
+
+void* realloc(void* p, size_t size) __THROW
+{
+	if (counting)
+	{
+		++allocations;
+	}
+	return __libc_realloc(p, size);
+}
+
+}
+
+//-----------------------------------------------------------------------------
+
+static void add_launcher(const gchar* dir, std::vector<GarconMenuItem*>& menu_items, std::vector<Element*>& items, const gchar* id, const gchar* name, const gchar* generic_name, const gchar* comment, const gchar* keywords, const gchar* command)
+{
+	gchar* contents = g_strdup_printf("[Desktop Entry]\nType=Application\nName=%s\nGenericName=%s\nComment=%s\nKeywords=%s\nExec=%s\n",
+			name, generic_name, comment, keywords, command);
+	gchar* path = g_build_filename(dir, id, NULL);
+	GarconMenuItem* item = NULL;
+	if (g_file_set_contents(path, contents, -1, NULL))
+	{
+		item = garcon_menu_item_new_for_path(path);
+		g_remove(path);
+	}
+	g_free(path);
+	g_free(contents);
+	if (item)
+	{
+		menu_items.push_back(item);
+		items.push_back(new Launcher(item));
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+// Buffers kept between searches, as in SearchPage
+struct Buffers
+{
+	std::vector<guint> candidates;
+	SearchIndex::CandidateBuffers candidate_buffers;
+	std::vector<guint> prefix_ids;
+	std::vector<guint> prefix_relevancies;
+};
+
+//-----------------------------------------------------------------------------
+
+// Types text one character at a time and then erases it, searching the
+// index like SearchPage after each keystroke, and returns how many
+// keystrokes allocated
+static unsigned int replay(Query& query, const SearchIndex& index, Buffers& buffers, const std::string& text, bool report)
+{
+	const SearchCorpus& corpus = index.get_corpus();
+	std::vector<guint>& candidates = buffers.candidates;
+	std::vector<guint>& prefix_ids = buffers.prefix_ids;
+	std::vector<guint>& prefix_relevancies = buffers.prefix_relevancies;
+
+	unsigned int keystrokes = 0;
+	std::string typed;
+	typed.reserve(text.length());
+	for (std::string::size_type i = 0, end = text.length() * 2; i < end; ++i)
+	{
+		if (i < text.length())
+		{
+			typed.push_back(text[i]);
+		}
+		else
+		{
+			typed.erase(typed.length() - 1);
+		}
+
+		counting = true;
+		allocations = 0;
+		query.set(typed);
+		index.find_candidates(query, candidates, buffers.candidate_buffers);
+		index.find_prefix_matches(query, prefix_ids, prefix_relevancies);
+		for (std::vector<guint>::size_type j = 0, count = candidates.size(); j < count; ++j)
+		{
+			corpus.search(candidates[j], query);
+		}
+		for (guint id = 0, count = corpus.size(); id < count; ++id)
+		{
+			corpus.search_approximate(id, query);
+		}
+		for (std::vector<guint>::size_type j = 0, count = prefix_ids.size(); j < count; ++j)
+		{
+			prefix_relevancies[prefix_ids[j]] = G_MAXUINT;
+		}
+		prefix_ids.clear();
+		counting = false;
+
+		if (allocations)
+		{
+			++keystrokes;
+			if (report)
+			{
+				fprintf(stderr, "\"%s\" allocated %u times\n", typed.c_str(), allocations);
+			}
+		}
+	}
+	return keystrokes;
+}
+
+//-----------------------------------------------------------------------------
+
+int main()
+{
+	gchar* dir = g_dir_make_tmp("zorinmenulite-test-XXXXXX", NULL);
+	if (!dir)
+	{
+		return EXIT_FAILURE;
+	}
+
+	std::vector<GarconMenuItem*> menu_items;
+	std::vector<Element*> items;
+	add_launcher(dir, menu_items, items, "writer.desktop", "LibreOffice Writer", "Word Processor", "Create and edit text and graphics in letters, reports, documents and Web pages", "Text;Letter;Fax;Document;OpenDocument Text;", "libreoffice --writer %U");
+	add_launcher(dir, menu_items, items, "firefox.desktop", "Firefox Web Browser", "Web Browser", "Browse the World Wide Web", "Internet;WWW;Browser;Web;Explorer;", "firefox %u");
+	add_launcher(dir, menu_items, items, "files.desktop", "Files", "File Manager", "Access and organize files", "folder;manager;explore;disk;filesystem;", "nautilus --new-window %U");
+	add_launcher(dir, menu_items, items, "terminal.desktop", "Terminal", "Terminal Emulator", "Use the command line", "shell;prompt;command;commandline;cmd;", "gnome-terminal");
+	g_rmdir(dir);
+	g_free(dir);
+	if (items.size() != 4)
+	{
+		fprintf(stderr, "could not create launchers\n");
+		return EXIT_FAILURE;
+	}
+
+	SearchIndex index;
+	index.build(items);
+
+	// Grow buffers with the longest query first, as they are kept afterwards
+	Query query;
+	Buffers buffers;
+	buffers.prefix_relevancies.assign(index.get_corpus().size(), G_MAXUINT);
+	const std::string text = "Open Office Writer document";
+	replay(query, index, buffers, text, false);
+
+	unsigned int keystrokes = replay(query, index, buffers, text, true);
+
+	index.clear();
+	for (std::vector<Element*>::size_type i = 0, end = items.size(); i < end; ++i)
+	{
+		delete items[i];
+		g_object_unref(menu_items[i]);
+	}
+
+	if (keystrokes)
+	{
+		fprintf(stderr, "%u keystrokes allocated\n", keystrokes);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}